@@ -131,7 +131,11 @@ void loop() {
         Serial.println(tIndex);
 #endif
         uint16_t tFrequency = NoteC5ToC7Pentatonic[tIndex];
-        tone(TONE_PIN, tFrequency);
+#if defined(ENABLE_INVERTED_OUTPUT)
+        tone(TONE_PIN, tFrequency); // the interrupt of tone() is required for the inverted output
+#else
+        setLivePitch(TONE_PIN, tFrequency); // changes the pitch without a click and keeps the tone if the note does not change
+#endif
         delay(200); // add an additional delay to make is easier to play a melody
     } else {
         if (tLightValue < LIGHT_LOW_THRESHOLD && tLightValue < sMinimum + 2) {
@@ -141,6 +145,9 @@ void loop() {
              * More RTTTL songs can be found under http://www.picaxe.com/RTTTL-Ringtones-for-Tune-Command/
              *
              */
+#if !defined(ENABLE_INVERTED_OUTPUT)
+            stopLivePitch(); // the melody is played by tone()
+#endif
             startPlayRandomRtttlFromArrayPGMAndPrintName(TONE_PIN, RTTTLMelodies, ARRAY_SIZE_MELODIES, &Serial);
             int tThresholdCount = 0;
             while (updatePlayRtttl()) {
@@ -168,7 +175,11 @@ void loop() {
             /*
              * Play tone
              */
+#if defined(ENABLE_INVERTED_OUTPUT)
             tone(TONE_PIN, tLightValue * 4);
+#else
+            setLivePitch(TONE_PIN, tLightValue * 4);
+#endif
         }
     }
 }
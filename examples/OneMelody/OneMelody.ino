@@ -28,6 +28,8 @@
 #include <Arduino.h>
 
 //#define USE_NO_RTX_EXTENSIONS // Disables RTX format definitions `'s'` (style) and `'l'` (loop). Saves up to 332 bytes program memory
+//#define USE_SOFTWARE_TONE_OUTPUT // Generates the tone on any pin by a fixed rate interrupt of Timer1, see "Software tone" in README.md
+//#define USE_WAVETABLE_OUTPUT // Plays a sine with attack and release on pin 9 or 10 by a Timer1 PWM interrupt, see "Wavetable output" in README.md
 #include <PlayRtttl.hpp>
 
 #if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__) || defined(__AVR_ATtiny87__) || defined(__AVR_ATtiny167__)
@@ -38,6 +40,7 @@
 /*
  * Only tone at pin1 and 4 are generated by hardware.
  * If generated by software, the millis() interrupt disturbs the tone generation on an 1 MHz ATtiny.
+ * With USE_SOFTWARE_TONE_OUTPUT every pin can be used, the millis() interrupt then only delays single edges.
  */
 const int TONE_PIN = 1; // use pin 1 (also used for internal LED :-( ) since pin 4 is connected to USB
 #else
@@ -0,0 +1,150 @@
+/*
+ * Arduino.h
+ *
+ * Minimal Arduino HAL for building PlayRtttl on a Linux host.
+ * Time is virtual, it only advances by delay(), delayMicroseconds() or hostAdvanceMicros().
+ * tone(), noTone() and digitalWrite() are recorded as events instead of driving a pin.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#ifndef _ARDUINO_HOST_H
+#define _ARDUINO_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARDUINO_HOST
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+/*
+ * Flash is plain memory on the host
+ */
+#define PROGMEM
+#define pgm_read_byte(aAddress)  (*(const uint8_t *)(aAddress))
+#define pgm_read_word(aAddress)  (*(const uint16_t *)(aAddress))
+#define pgm_read_dword(aAddress) (*(const uint32_t *)(aAddress))
+#define pgm_read_ptr(aAddress)   (*(void * const *)(aAddress))
+class __FlashStringHelper;
+#define F(aString) (reinterpret_cast<const __FlashStringHelper *>(aString))
+
+#define _BV(aBit) (1 << (aBit))
+
+/*
+ * Virtual clock. Like on the target, millis() and micros() are 32 bit values which roll over.
+ */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long aMillis);
+void delayMicroseconds(unsigned int aMicros);
+void yield();
+#define noInterrupts()
+#define interrupts()
+void hostSetMicros(uint64_t aMicros); // e.g. to start shortly before a millis() rollover
+uint64_t hostGetMicros();
+void hostAdvanceMicros(uint64_t aMicros);
+
+/*
+ * Recorded output events
+ */
+#define HOST_EVENT_TONE         0
+#define HOST_EVENT_NO_TONE      1
+#define HOST_EVENT_DIGITAL_WRITE 2
+struct hostEvent {
+    uint64_t Micros;        // Virtual time of the call
+    uint32_t Duration;      // Duration argument of tone(), 0 if not given
+    uint16_t Frequency;     // Frequency argument of tone() or level of digitalWrite()
+    uint8_t Pin;
+    uint8_t Type;
+};
+void hostStartRecording(struct hostEvent *aEventBuffer, uint32_t aEventBufferSize); // nullptr disables recording
+uint32_t hostGetNumberOfEvents(); // Number of events since start, may be bigger than buffer size
+void hostPrintEvents(FILE *aFile);
+void hostRecordEvent(uint8_t aType, uint8_t aPin, uint16_t aFrequency, uint32_t aDuration); // e.g. for an output backend
+
+void tone(uint8_t aPin, unsigned int aFrequency, unsigned long aDuration = 0);
+void noTone(uint8_t aPin);
+void digitalWrite(uint8_t aPin, uint8_t aValue);
+void pinMode(uint8_t aPin, uint8_t aMode);
+int digitalRead(uint8_t aPin);
+int analogRead(uint8_t aPin);
+long random(long aMax);
+long random(long aMin, long aMax);
+void randomSeed(unsigned long aSeed);
+
+/*
+ * Serial output goes to stdout
+ */
+class Print {
+public:
+    virtual ~Print() {
+    }
+    virtual size_t write(uint8_t aChar) {
+        return fputc(aChar, stdout) == EOF ? 0 : 1;
+    }
+    size_t print(const char *aString) {
+        return fputs(aString, stdout) < 0 ? 0 : strlen(aString);
+    }
+    size_t print(const __FlashStringHelper *aString) {
+        return print(reinterpret_cast<const char*>(aString));
+    }
+    size_t print(char aChar) {
+        return write(aChar);
+    }
+    size_t print(unsigned char aValue, int aBase = 10) {
+        return print((unsigned long) aValue, aBase);
+    }
+    size_t print(int aValue, int aBase = 10) {
+        return print((long) aValue, aBase);
+    }
+    size_t print(unsigned int aValue, int aBase = 10) {
+        return print((unsigned long) aValue, aBase);
+    }
+    size_t print(long aValue, int aBase = 10) {
+        return printf(aBase == 16 ? "%lX" : "%ld", aValue);
+    }
+    size_t print(unsigned long aValue, int aBase = 10) {
+        return printf(aBase == 16 ? "%lX" : "%lu", aValue);
+    }
+    size_t println() {
+        return write('\n');
+    }
+    template<typename T> size_t println(T aValue) {
+        return print(aValue) + println();
+    }
+    template<typename T> size_t println(T aValue, int aBase) {
+        return print(aValue, aBase) + println();
+    }
+};
+
+class Stream: public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+extern Print Serial;
+
+#endif // _ARDUINO_HOST_H
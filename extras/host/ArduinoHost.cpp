@@ -0,0 +1,149 @@
+/*
+ * ArduinoHost.cpp
+ *
+ * Implementation of the minimal Arduino HAL for building PlayRtttl on a Linux host.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+
+Print Serial;
+
+static uint64_t sHostMicros;
+
+static struct hostEvent *sHostEventBuffer;
+static uint32_t sHostEventBufferSize;
+static uint32_t sHostNumberOfEvents;
+static uint64_t sHostRecordingStartMicros;
+
+unsigned long millis() {
+    return (uint32_t) (sHostMicros / 1000);
+}
+
+unsigned long micros() {
+    return (uint32_t) sHostMicros;
+}
+
+void delay(unsigned long aMillis) {
+    sHostMicros += aMillis * 1000ULL;
+}
+
+void delayMicroseconds(unsigned int aMicros) {
+    sHostMicros += aMicros;
+}
+
+void yield() {
+}
+
+void hostSetMicros(uint64_t aMicros) {
+    sHostMicros = aMicros;
+}
+
+uint64_t hostGetMicros() {
+    return sHostMicros;
+}
+
+void hostAdvanceMicros(uint64_t aMicros) {
+    sHostMicros += aMicros;
+}
+
+void hostStartRecording(struct hostEvent *aEventBuffer, uint32_t aEventBufferSize) {
+    sHostEventBuffer = aEventBuffer;
+    sHostEventBufferSize = aEventBufferSize;
+    sHostNumberOfEvents = 0;
+    sHostRecordingStartMicros = sHostMicros;
+}
+
+uint32_t hostGetNumberOfEvents() {
+    return sHostNumberOfEvents;
+}
+
+void hostRecordEvent(uint8_t aType, uint8_t aPin, uint16_t aFrequency, uint32_t aDuration) {
+    if (sHostEventBuffer != nullptr && sHostNumberOfEvents < sHostEventBufferSize) {
+        struct hostEvent *tEvent = &sHostEventBuffer[sHostNumberOfEvents];
+        tEvent->Micros = sHostMicros;
+        tEvent->Duration = aDuration;
+        tEvent->Frequency = aFrequency;
+        tEvent->Pin = aPin;
+        tEvent->Type = aType;
+    }
+    sHostNumberOfEvents++;
+}
+
+/*
+ * One line per event: <micros> <tone|noTone|digitalWrite> [<frequency or level> [<duration>]]
+ * The time is relative to the start of recording, so traces with different start times can be compared.
+ */
+void hostPrintEvents(FILE *aFile) {
+    uint32_t tNumberOfEvents = sHostNumberOfEvents;
+    if (tNumberOfEvents > sHostEventBufferSize) {
+        tNumberOfEvents = sHostEventBufferSize;
+    }
+    for (uint32_t i = 0; i < tNumberOfEvents; ++i) {
+        struct hostEvent *tEvent = &sHostEventBuffer[i];
+        unsigned long long tMicros = tEvent->Micros - sHostRecordingStartMicros;
+        if (tEvent->Type == HOST_EVENT_TONE) {
+            fprintf(aFile, "%llu tone %u %lu\n", tMicros, tEvent->Frequency, (unsigned long) tEvent->Duration);
+        } else if (tEvent->Type == HOST_EVENT_NO_TONE) {
+            fprintf(aFile, "%llu noTone\n", tMicros);
+        } else {
+            fprintf(aFile, "%llu digitalWrite %u\n", tMicros, tEvent->Frequency);
+        }
+    }
+}
+
+void tone(uint8_t aPin, unsigned int aFrequency, unsigned long aDuration) {
+    hostRecordEvent(HOST_EVENT_TONE, aPin, aFrequency, aDuration);
+}
+
+void noTone(uint8_t aPin) {
+    hostRecordEvent(HOST_EVENT_NO_TONE, aPin, 0, 0);
+}
+
+void digitalWrite(uint8_t aPin, uint8_t aValue) {
+    hostRecordEvent(HOST_EVENT_DIGITAL_WRITE, aPin, aValue, 0);
+}
+
+void pinMode(uint8_t aPin, uint8_t aMode) {
+    (void) aPin;
+    (void) aMode;
+}
+
+int digitalRead(uint8_t aPin) {
+    (void) aPin;
+    return LOW;
+}
+
+int analogRead(uint8_t aPin) {
+    (void) aPin;
+    return rand() & 0x3FF;
+}
+
+long random(long aMax) {
+    return aMax == 0 ? 0 : rand() % aMax;
+}
+
+long random(long aMin, long aMax) {
+    return aMin >= aMax ? aMin : aMin + random(aMax - aMin);
+}
+
+void randomSeed(unsigned long aSeed) {
+    srand(aSeed);
+}
@@ -0,0 +1,227 @@
+/*
+ * HostTimer2.h
+ *
+ * Model of Timer2 of the ATmega328P in CTC mode for the host, to check the register code of setLivePitch().
+ * Defines TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, GTCCR, TIMSK2 and SREG, so it must be included before PlayRtttl.hpp.
+ * Time is counted in CPU cycles and only advances by hostTimer2AdvanceCycles(). The register accesses take no time.
+ * The edges of the OC2A and OC2B pins are recorded with their cycle.
+ *
+ * Modeled behavior of the datasheet:
+ * - The counter is cleared at the timer clock after it reached OCR2A. If it is above OCR2A, it counts up to 0xFF and wraps to 0.
+ * - A compare match toggles OC2A or OC2B if COM2A0 or COM2B0 is set. The prescaler runs independently of the counter.
+ * - Writing TCNT2 blocks the compare match at the next timer clock.
+ * - Writing FOC2A or FOC2B to TCCR2B toggles the pin, without clearing the counter.
+ * - Writing PSRASY to GTCCR resets the prescaler of Timer2.
+ * - OCR2A and OCR2B are not double buffered in CTC mode.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#ifndef _HOST_TIMER2_H
+#define _HOST_TIMER2_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Bits of TCCR2A and TCCR2B
+#define WGM21   1
+#define COM2B0  4
+#define COM2A0  6
+#define FOC2B   6
+#define FOC2A   7
+#define PSRASY  1
+
+#define NOT_ON_TIMER    0
+#define TIMER2A         1
+#define TIMER2B         2
+// OC2A is pin 11 and OC2B is pin 3 on Uno and Nano
+#define digitalPinToTimer(aPin) ((aPin) == 11 ? TIMER2A : ((aPin) == 3 ? TIMER2B : NOT_ON_TIMER))
+
+#define HOST_TIMER2_NEVER   0xFFFFFFFF
+
+struct hostTimer2 {
+    uint64_t Cycles;
+    uint64_t PrescalerResetCycles; // timer clocks are at multiples of the prescaler after this cycle
+    uint8_t ControlA;
+    uint8_t ControlB;           // only the prescaler bits CS22 to CS20
+    uint8_t Counter;
+    uint8_t CompareA;
+    uint8_t CompareB;
+    uint8_t GeneralControl;
+    bool IsMatchBlocked;
+    std::vector<uint64_t> EdgeCycles; // edges of OC2A and OC2B
+};
+struct hostTimer2 sHostTimer2;
+
+static uint16_t getHostTimer2Prescaler() {
+    static const uint16_t sPrescalers[] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+    return sPrescalers[sHostTimer2.ControlB & 0x07];
+}
+
+static void toggleHostTimer2Output(uint8_t aCompareOutputModeBit) {
+    if (sHostTimer2.ControlA & _BV(aCompareOutputModeBit)) {
+        sHostTimer2.EdgeCycles.push_back(sHostTimer2.Cycles);
+    }
+}
+
+/*
+ * Number of timer clocks until the counter has the value aValue, HOST_TIMER2_NEVER if it does not reach it
+ */
+static uint32_t getHostTimer2ClocksToValue(uint8_t aValue) {
+    uint8_t tCounter = sHostTimer2.Counter;
+    uint8_t tTop = sHostTimer2.CompareA;
+    if (tCounter < tTop) {
+        if (aValue > tCounter && aValue <= tTop) {
+            return aValue - tCounter;
+        }
+        return aValue <= tTop ? (tTop - tCounter) + 1 + aValue : HOST_TIMER2_NEVER;
+    }
+    if (tCounter == tTop) {
+        return aValue <= tTop ? aValue + 1 : HOST_TIMER2_NEVER;
+    }
+    if (aValue > tCounter) {
+        return aValue - tCounter;
+    }
+    return aValue <= tTop ? (256 - tCounter) + aValue : HOST_TIMER2_NEVER;
+}
+
+/*
+ * Advances the counter by aClocks timer clocks, without reaching OCR2A or OCR2B
+ */
+static void skipHostTimer2Clocks(uint32_t aClocks) {
+    if (aClocks == 0) {
+        return;
+    }
+    if (sHostTimer2.Counter == sHostTimer2.CompareA) {
+        sHostTimer2.Counter = aClocks - 1;
+    } else {
+        sHostTimer2.Counter += aClocks;
+    }
+    sHostTimer2.IsMatchBlocked = false;
+}
+
+static void clockHostTimer2() {
+    sHostTimer2.Counter = (sHostTimer2.Counter == sHostTimer2.CompareA) ? 0 : sHostTimer2.Counter + 1;
+    if (!sHostTimer2.IsMatchBlocked) {
+        if (sHostTimer2.Counter == sHostTimer2.CompareA) {
+            toggleHostTimer2Output(COM2A0);
+        }
+        if (sHostTimer2.Counter == sHostTimer2.CompareB) {
+            toggleHostTimer2Output(COM2B0);
+        }
+    }
+    sHostTimer2.IsMatchBlocked = false;
+}
+
+void hostTimer2AdvanceCycles(uint64_t aCycles) {
+    uint64_t tEndCycles = sHostTimer2.Cycles + aCycles;
+    uint16_t tPrescaler = getHostTimer2Prescaler();
+    if (tPrescaler == 0) {
+        sHostTimer2.Cycles = tEndCycles;
+        return;
+    }
+    while (true) {
+        uint64_t tStartClock = (sHostTimer2.Cycles - sHostTimer2.PrescalerResetCycles) / tPrescaler;
+        uint64_t tClocks = (tEndCycles - sHostTimer2.PrescalerResetCycles) / tPrescaler - tStartClock;
+        if (tClocks == 0) {
+            break;
+        }
+        // Jump to the next clock, where the counter reaches a compare value
+        uint32_t tClocksToMatch = 1;
+        if (!sHostTimer2.IsMatchBlocked) {
+            tClocksToMatch = getHostTimer2ClocksToValue(sHostTimer2.CompareA);
+            uint32_t tClocksToMatchB = getHostTimer2ClocksToValue(sHostTimer2.CompareB);
+            if (tClocksToMatch > tClocksToMatchB) {
+                tClocksToMatch = tClocksToMatchB;
+            }
+        }
+        if (tClocksToMatch > tClocks) {
+            skipHostTimer2Clocks(tClocks);
+            break;
+        }
+        skipHostTimer2Clocks(tClocksToMatch - 1);
+        sHostTimer2.Cycles = sHostTimer2.PrescalerResetCycles + (tStartClock + tClocksToMatch) * tPrescaler;
+        clockHostTimer2();
+    }
+    sHostTimer2.Cycles = tEndCycles;
+}
+
+/*
+ * A register with the side effects of a write
+ */
+class hostTimer2Register {
+public:
+    explicit hostTimer2Register(uint8_t *aValue) :
+            Value(aValue) {
+    }
+    operator uint8_t() const {
+        return *Value;
+    }
+    hostTimer2Register& operator=(uint8_t aValue);
+    hostTimer2Register& operator|=(uint8_t aValue) {
+        return *this = *Value | aValue;
+    }
+    hostTimer2Register& operator&=(uint8_t aValue) {
+        return *this = *Value & aValue;
+    }
+private:
+    uint8_t *Value;
+};
+
+hostTimer2Register& hostTimer2Register::operator=(uint8_t aValue) {
+    if (Value == &sHostTimer2.ControlB) {
+        if (aValue & _BV(FOC2A)) {
+            toggleHostTimer2Output(COM2A0);
+        }
+        if (aValue & _BV(FOC2B)) {
+            toggleHostTimer2Output(COM2B0);
+        }
+        aValue &= 0x07;
+    } else if (Value == &sHostTimer2.Counter) {
+        sHostTimer2.IsMatchBlocked = true;
+    } else if (Value == &sHostTimer2.GeneralControl) {
+        if (aValue & _BV(PSRASY)) {
+            sHostTimer2.PrescalerResetCycles = sHostTimer2.Cycles;
+        }
+        aValue &= ~_BV(PSRASY); // cleared by hardware
+    }
+    *Value = aValue;
+    return *this;
+}
+
+hostTimer2Register sHostTCCR2A(&sHostTimer2.ControlA);
+hostTimer2Register sHostTCCR2B(&sHostTimer2.ControlB);
+hostTimer2Register sHostTCNT2(&sHostTimer2.Counter);
+hostTimer2Register sHostOCR2A(&sHostTimer2.CompareA);
+hostTimer2Register sHostOCR2B(&sHostTimer2.CompareB);
+hostTimer2Register sHostGTCCR(&sHostTimer2.GeneralControl);
+uint8_t sHostTIMSK2;
+uint8_t sHostSREG;
+
+#define TCCR2A  sHostTCCR2A
+#define TCCR2B  sHostTCCR2B
+#define TCNT2   sHostTCNT2
+#define OCR2A   sHostOCR2A
+#define OCR2B   sHostOCR2B
+#define GTCCR   sHostGTCCR
+#define TIMSK2  sHostTIMSK2
+#define SREG    sHostSREG
+#define cli()
+
+#endif // _HOST_TIMER2_H
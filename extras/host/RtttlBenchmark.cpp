@@ -0,0 +1,775 @@
+/*
+ * RtttlBenchmark.cpp
+ *
+ * Plays all included melodies on the host in virtual time and reports ns per note and simulated duration.
+ * Time is advanced directly to the next note, so the measured time is the pure time of parsing and starting the notes.
+ *
+ * With -l, the songs are additionally played by a simulated loop, which is blocked for a random time of up to the given
+ * milliseconds at each iteration, e.g. by pulseIn(). The lateness of each note start compared to the first run is reported.
+ * With -i, the notes are played by a simulated timer interrupt with the given period instead of by the loop.
+ * With -d, the late notes are handled by the given policy of setPlayRtttlLatePolicy() and the number of shortened and dropped
+ * notes and the delay of the end of the song are reported.
+ *
+ * With -p, the songs are additionally played with sleepUntilPlayRtttlNextAction() and the wakeups and the current of an
+ * ATmega328P sleeping in idle mode are estimated and compared with the busy loop of playRtttlBlocking().
+ *
+ * If built with USE_RTTTL_STATISTICS by "make statistics", the statistics of the library collected during the runs with -l
+ * are printed and checked against the lateness measured by this program.
+ *
+ * Usage: RtttlBenchmark [-c | -m | -k] [-t] [-p] [-s] [-u] [-r <repetitions>] [-o <start time in microseconds>] [-l <maximum loop blocking ms> [-i <period in us>] [-d <late policy>]]
+ *   -c  Convert songs to compiled format before playing
+ *   -m  Play songs with startPlayRtttl() from RAM instead of startPlayRtttlPGM()
+ *   -k  Pack all songs into one bank by RtttlPacker.h and play them with startPlayRtttlPackedPGM()
+ *   -t  Print the emitted tone() / noTone() trace of each song
+ *   -p  Report wakeups and estimated current for sleeping between the notes
+ *   -s  Check the trace after seeking with and without index, check seeking with the index of an empty song and behind the maximum offset
+ *       and report the time for seeking to 7/8 of the song
+ *   -u  Check the trace after interrupting each song at 1/3 by pushPlayRtttlPGM() of the song Short and resuming it
+ *   -r  Number of repetitions for the time measurement, default 100
+ *   -o  Start value of the virtual clock, e.g. 4294960000 to test micros() rollover
+ *   -l  Report note start lateness for a loop blocking for up to this milliseconds
+ *   -i  Play notes by a timer interrupt with this period in microseconds, e.g. 1000
+ *   -d  Policy for late notes, 0 = shift (default), 1 = shorten, 2 = drop
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <string> // for RtttlPacker.h, before PlayRtttl.hpp, which defines isdigit() as macro
+#include <vector>
+
+#include "PlayRtttl.hpp"
+#include "RtttlPacker.h"
+
+#define TONE_PIN                11
+#define EVENT_BUFFER_SIZE       1024
+#define COMPILED_BUFFER_SIZE    512
+#define MAXIMUM_SONG_MICROS     (3600 * 1000000ULL) // Stop songs which do not end within one hour of virtual time
+
+struct hostEvent sEventBuffer[EVENT_BUFFER_SIZE];
+struct hostEvent sLatencyEventBuffer[EVENT_BUFFER_SIZE];
+uint16_t sCompiledBuffer[COMPILED_BUFFER_SIZE];
+
+bool sUseCompiled = false;
+bool sUseRAM = false; // use startPlayRtttl() instead of startPlayRtttlPGM()
+bool sUsePacked = false;
+std::vector<uint8_t> sPackedBank;
+uint8_t sPackedSongIndex; // Index of the current song in sPackedBank
+uint32_t sMaximumLoopBlockingMicros = 0; // 0 -> no lateness measurement
+uint32_t sInterruptPeriodMicros = 0; // 0 -> notes are played by updatePlayRtttl() in loop
+uint8_t sLatePolicy = RTTTL_LATE_POLICY_SHIFT;
+
+/*
+ * Model of an ATmega328P at 16 MHz and 5 V sleeping in idle mode. The currents are typical datasheet values
+ * for the bare chip, a board with USB chip, regulator and LEDs draws more. The times are estimates.
+ */
+bool sEstimatePower = false;
+bool sCheckSeek = false;
+bool sCheckPushPop = false;
+struct hostEvent sAlertEventBuffer[64];
+#define MILLIS_TIMER_PERIOD_MICROS  1024 // Timer0 overflow interrupt for millis()
+#define SLEEP_MINIMUM_MICROS        (MILLIS_TIMER_PERIOD_MICROS + 50) // Same as in sleepUntilNextAction()
+#define WAKEUP_ACTIVE_MICROS        10   // ISR, micros() and comparison in sleepUntilNextAction()
+#define UPDATE_ACTIVE_MICROS        100  // updatePlayRtttl() with start and decode of a note
+#define ACTIVE_MILLIAMPERE          9.2
+#define IDLE_MILLIAMPERE            2.7
+
+struct powerEstimate {
+    uint64_t Wakeups;
+    uint64_t Updates;
+    uint64_t ActiveMicros;
+    uint64_t Micros;
+};
+struct powerEstimate sToneSleepTotal;
+struct powerEstimate sTimer2SleepTotal;
+uint64_t sBusyLoopUpdates;
+
+/*
+ * Lateness statistics over all songs
+ */
+uint32_t sNumberOfLatenessValues;
+double sSumOfLateness;
+double sSumOfSquaredLateness;
+uint32_t sMaximumLateness;
+uint32_t sNumberOfShortenedNotes;
+uint32_t sNumberOfDroppedNotes;
+uint64_t sSumOfEndDelayMicros; // delay of the end of the songs compared to the first run
+uint32_t sMaximumEndDelayMicros;
+uint64_t sInfoNanos; // time of getRtttlInfoPGM() for all songs
+#if defined(USE_RTTTL_STATISTICS)
+struct rtttlStatistics sLoopLatencyStatistics; // The library statistics of all runs with loop latency
+#endif
+
+static uint64_t getNanoseconds() {
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return (uint64_t) tTime.tv_sec * 1000000000ULL + tTime.tv_nsec;
+}
+
+/*
+ * Plays the song until end and returns the simulated duration in microseconds
+ */
+static void startSong(const char *aSongPGM) {
+    if (sUseCompiled) {
+        startPlayRtttlCompiled(TONE_PIN, sCompiledBuffer);
+    } else if (sUsePacked) {
+        startPlayRtttlPackedPGM(TONE_PIN, sPackedBank.data(), sPackedSongIndex);
+    } else if (sUseRAM) {
+        // On the host, program memory is RAM, but the song is read by the parser for RAM
+        startPlayRtttl(TONE_PIN, aSongPGM);
+    } else {
+        startPlayRtttlPGM(TONE_PIN, aSongPGM);
+    }
+}
+
+/*
+ * Plays the started song until end
+ */
+static void playToEnd(uint64_t aStartMicros) {
+    while (updatePlayRtttl()) {
+        // Jump directly to the next note
+        int32_t tMicrosToWait = (int32_t) (sPlayRtttlState.MicrosOfNextAction - (uint32_t) micros());
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+        // or to the end of the tone
+        int32_t tMicrosToToneEnd = (int32_t) (sPlayRtttlState.MicrosOfToneEnd - (uint32_t) micros());
+        if (sPlayRtttlState.IsToneOn && tMicrosToToneEnd < tMicrosToWait) {
+            tMicrosToWait = tMicrosToToneEnd;
+        }
+#endif
+        hostAdvanceMicros(tMicrosToWait > 0 ? tMicrosToWait : 1);
+        if (hostGetMicros() - aStartMicros > MAXIMUM_SONG_MICROS) {
+            stopPlayRtttl();
+            printf("Song did not end within %llu s of virtual time\n", MAXIMUM_SONG_MICROS / 1000000ULL);
+            break;
+        }
+    }
+}
+
+static uint64_t playSong(const char *aSongPGM) {
+    uint64_t tStartMicros = hostGetMicros();
+    setPlayRtttlUpdateFromInterrupt(false);
+    startSong(aSongPGM);
+    playToEnd(tStartMicros);
+    return hostGetMicros() - tStartMicros;
+}
+
+static bool isSameEvent(const struct hostEvent *aEvent, const struct hostEvent *aExpectedEvent, uint64_t aShiftMicros) {
+    return aEvent->Micros == aExpectedEvent->Micros + aShiftMicros && aEvent->Frequency == aExpectedEvent->Frequency
+            && aEvent->Duration == aExpectedEvent->Duration && aEvent->Type == aExpectedEvent->Type;
+}
+
+/*
+ * Plays the song until aOffsetMicros, interrupts it by the song Short with pushPlayRtttlPGM() and plays it to end.
+ * Returns true if the trace is the trace of the first run in aEvents, with the trace of Short and the noTone() of popPlayRtttl()
+ * inserted at aOffsetMicros and the following events delayed by the duration of Short.
+ */
+static bool checkPushPop(const char *aSongPGM, const struct hostEvent *aEvents, uint32_t aNumberOfEvents, uint32_t aOffsetMicros) {
+    uint64_t tStartMicros = hostGetMicros();
+    hostStartRecording(sAlertEventBuffer, sizeof(sAlertEventBuffer) / sizeof(sAlertEventBuffer[0]));
+    startPlayRtttlPGM(TONE_PIN, Short);
+    playToEnd(tStartMicros);
+    uint32_t tNumberOfAlertEvents = hostGetNumberOfEvents();
+    uint64_t tAlertMicros = hostGetMicros() - tStartMicros;
+
+    hostSetMicros(tStartMicros);
+    hostStartRecording(sLatencyEventBuffer, EVENT_BUFFER_SIZE);
+    startSong(aSongPGM);
+    // Play until the offset, but not the note which is due at the offset
+    while (hostGetMicros() - tStartMicros < aOffsetMicros && updatePlayRtttl()) {
+        uint64_t tMicrosToOffset = aOffsetMicros - (hostGetMicros() - tStartMicros);
+        uint64_t tMicrosToWait = getPlayRtttlMicrosToNextAction();
+        if (tMicrosToWait > tMicrosToOffset) {
+            tMicrosToWait = tMicrosToOffset;
+        }
+        hostAdvanceMicros(tMicrosToWait > 0 ? tMicrosToWait : 1);
+    }
+    uint32_t tNumberOfEventsBeforePush = hostGetNumberOfEvents();
+    if (!pushPlayRtttlPGM(TONE_PIN, Short)) {
+        return false;
+    }
+    playToEnd(tStartMicros);
+
+    uint32_t tNumberOfEvents = hostGetNumberOfEvents();
+    if (tNumberOfEvents != aNumberOfEvents + tNumberOfAlertEvents + 1 || tNumberOfEvents > EVENT_BUFFER_SIZE) {
+        return false;
+    }
+    const struct hostEvent *tEvent = sLatencyEventBuffer;
+    for (uint32_t i = 0; i < tNumberOfEventsBeforePush; ++i) {
+        if (!isSameEvent(tEvent++, &aEvents[i], 0)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < tNumberOfAlertEvents; ++i) {
+        if (!isSameEvent(tEvent++, &sAlertEventBuffer[i], aOffsetMicros)) {
+            return false;
+        }
+    }
+    // noTone() of popPlayRtttl()
+    if (tEvent->Type != HOST_EVENT_NO_TONE || tEvent->Micros != tStartMicros + aOffsetMicros + tAlertMicros) {
+        return false;
+    }
+    tEvent++;
+    for (uint32_t i = tNumberOfEventsBeforePush; i < aNumberOfEvents; ++i) {
+        if (!isSameEvent(tEvent++, &aEvents[i], tAlertMicros)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Starts the song, seeks to aOffsetMillis and plays it to end.
+ * Returns true if the trace is the trace of the first run in aEvents from aOffsetMillis on, except the first, shortened note.
+ */
+static bool checkSeek(const char *aSongPGM, const struct hostEvent *aEvents, uint32_t aNumberOfEvents,
+        const struct rtttlSeekIndex *aSeekIndex, uint32_t aOffsetMillis) {
+    uint64_t tStartMicros = hostGetMicros();
+    startSong(aSongPGM);
+    hostStartRecording(sLatencyEventBuffer, EVENT_BUFFER_SIZE);
+    if (!seekPlayRtttl(aOffsetMillis, aSeekIndex)) {
+        return false;
+    }
+    playToEnd(tStartMicros);
+
+    uint64_t tOffsetMicros = aOffsetMillis * 1000ULL;
+    uint32_t tFirstEvent = 0;
+    while (tFirstEvent < aNumberOfEvents && aEvents[tFirstEvent].Micros - aEvents[0].Micros <= tOffsetMicros) {
+        tFirstEvent++;
+    }
+    uint32_t tNumberOfEvents = hostGetNumberOfEvents();
+    if (tNumberOfEvents - 1 != aNumberOfEvents - tFirstEvent || tNumberOfEvents > EVENT_BUFFER_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 1; i < tNumberOfEvents; ++i) {
+        const struct hostEvent *tEvent = &aEvents[tFirstEvent + i - 1];
+        const struct hostEvent *tSeekEvent = &sLatencyEventBuffer[i];
+        if (tSeekEvent->Micros - tStartMicros + tOffsetMicros != tEvent->Micros - aEvents[0].Micros
+                || tSeekEvent->Frequency != tEvent->Frequency || tSeekEvent->Duration != tEvent->Duration
+                || tSeekEvent->Type != tEvent->Type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The index of an empty song has no checkpoint. Seeking with it must return false without reading Checkpoints[].
+ * Returns true if this is the case for the empty song and for a song, which loops forever, so that no offset is behind its end.
+ */
+static bool checkSeekWithEmptyIndex() {
+    static const char EmptySong[] = "Empty:d=4,o=5,b=100:";
+    static const char EmptyForeverSong[] = "EmptyForever:d=4,o=5,b=100,l=0:"; // is indexed for one loop, but cannot be played
+    static const char ForeverSong[] = "Forever:d=4,o=5,b=100,l=0:c,e,g";
+    struct rtttlSeekIndex tSeekIndex;
+    for (const char *tSong : { EmptySong, EmptyForeverSong }) {
+        // The checkpoints of ForeverSong are left in Checkpoints[] and must not be used for seeking in ForeverSong
+        buildRtttlSeekIndex(ForeverSong, &tSeekIndex);
+        buildRtttlSeekIndex(tSong, &tSeekIndex);
+        if (tSeekIndex.NumberOfCheckpoints != 0 || tSeekIndex.DurationOfLoopMicros != 0) {
+            return false;
+        }
+        startPlayRtttl(TONE_PIN, ForeverSong);
+        if (seekPlayRtttl(1000, &tSeekIndex)) {
+            return false;
+        }
+    }
+    startPlayRtttl(TONE_PIN, EmptySong);
+    if (seekPlayRtttl(0, &tSeekIndex) || seekPlayRtttl(1000, &tSeekIndex)) {
+        return false;
+    }
+    stopPlayRtttl();
+    return true;
+}
+
+/*
+ * A song looping forever has no end, so all offsets up to RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS can be seeked.
+ * Returns true if a greater offset, which overflows in microseconds, returns false.
+ */
+static bool checkSeekMaximumOffset() {
+    static const char ForeverSong[] = "Forever:d=4,o=5,b=100,l=0:c,e,g";
+    struct rtttlSeekIndex tSeekIndex;
+    buildRtttlSeekIndex(ForeverSong, &tSeekIndex);
+    for (const struct rtttlSeekIndex *tSeekIndexPtr : { (const struct rtttlSeekIndex*) nullptr, (const struct rtttlSeekIndex*) &tSeekIndex }) {
+        startPlayRtttl(TONE_PIN, ForeverSong);
+        if (!seekPlayRtttl(RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS, tSeekIndexPtr)) {
+            return false;
+        }
+        startPlayRtttl(TONE_PIN, ForeverSong);
+        if (seekPlayRtttl(RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS + 1, tSeekIndexPtr)) {
+            return false;
+        }
+    }
+    stopPlayRtttl();
+    return true;
+}
+
+/*
+ * Plays the song by a loop, which is blocked for a random time at each iteration.
+ * If sInterruptPeriodMicros is not 0, updatePlayRtttlFromInterrupt() is called periodically during the blocking time.
+ */
+static void playSongWithLoopLatency(const char *aSongPGM) {
+    uint64_t tStartMicros = hostGetMicros();
+    setPlayRtttlUpdateFromInterrupt(sInterruptPeriodMicros != 0);
+    startSong(aSongPGM);
+    // the timer runs independently of the song, so start with a random phase
+    uint64_t tNextInterruptMicros = tStartMicros + 1 + random(sInterruptPeriodMicros);
+    while (updatePlayRtttl()) {
+        uint64_t tEndOfBlockingMicros = hostGetMicros() + 1 + random(sMaximumLoopBlockingMicros);
+        if (sInterruptPeriodMicros != 0) {
+            while (tNextInterruptMicros <= tEndOfBlockingMicros) {
+                hostSetMicros(tNextInterruptMicros);
+                updatePlayRtttlFromInterrupt();
+                tNextInterruptMicros += sInterruptPeriodMicros;
+            }
+        }
+        hostSetMicros(tEndOfBlockingMicros);
+        if (hostGetMicros() - tStartMicros > MAXIMUM_SONG_MICROS) {
+            stopPlayRtttl();
+            break;
+        }
+    }
+    setPlayRtttlUpdateFromInterrupt(false);
+}
+
+/*
+ * Sleeps from aMicros to the next action at aDeadline like sleepUntilNextAction() on AVR.
+ * The CPU is woken up by the Timer0 overflow and, if aToneHalfPeriodMicros is not 0, by the tone() interrupt at each toggle of the pin.
+ * Returns the time the next action is done.
+ */
+static void sleepUntil(uint64_t aMicros, uint64_t aDeadline, uint64_t aToneStartMicros, uint64_t aToneEndMicros,
+        double aToneHalfPeriodMicros, struct powerEstimate *aEstimate) {
+    aEstimate->Updates++;
+    aEstimate->ActiveMicros += UPDATE_ACTIVE_MICROS;
+    uint64_t tMicros = aMicros + UPDATE_ACTIVE_MICROS;
+    while (tMicros < aDeadline && aDeadline - tMicros > SLEEP_MINIMUM_MICROS) {
+        uint64_t tNextWakeup = (tMicros / MILLIS_TIMER_PERIOD_MICROS + 1) * MILLIS_TIMER_PERIOD_MICROS;
+        if (aToneHalfPeriodMicros > 0 && tMicros >= aToneStartMicros && tMicros < aToneEndMicros) {
+            uint64_t tNextToggle = aToneStartMicros
+                    + (uint64_t) ((floor((tMicros - aToneStartMicros) / aToneHalfPeriodMicros) + 1) * aToneHalfPeriodMicros);
+            if (tNextToggle <= tMicros) {
+                tNextToggle = tMicros + 1; // rounding of non integer half periods
+            }
+            if (tNextToggle < tNextWakeup) {
+                tNextWakeup = tNextToggle;
+            }
+        }
+        tMicros = tNextWakeup;
+        aEstimate->Wakeups++;
+        aEstimate->ActiveMicros += WAKEUP_ACTIVE_MICROS;
+    }
+    if (tMicros < aDeadline) {
+        // busy wait with delayMicroseconds()
+        aEstimate->ActiveMicros += aDeadline - tMicros;
+    }
+}
+
+/*
+ * Uses the trace of the first run in sEventBuffer.
+ * For tone(), the only actions are the starts of the notes, but the tone() interrupt toggles the pin.
+ * For USE_DIRECT_TIMER2_OUTPUT, the pin is toggled by hardware, but the end of each tone is an additional action.
+ */
+static void estimatePower(uint32_t aNumberOfEvents, struct powerEstimate *aToneSleep, struct powerEstimate *aTimer2Sleep) {
+    for (uint32_t i = 0; i + 1 < aNumberOfEvents && i + 1 < EVENT_BUFFER_SIZE; ++i) {
+        struct hostEvent *tEvent = &sEventBuffer[i];
+        uint64_t tStart = tEvent->Micros;
+        uint64_t tNextStart = sEventBuffer[i + 1].Micros;
+        if (tEvent->Type == HOST_EVENT_TONE && tEvent->Frequency != 0) {
+            uint64_t tToneEnd = tStart + tEvent->Duration * 1000ULL;
+            if (tToneEnd > tNextStart) {
+                tToneEnd = tNextStart;
+            }
+            sleepUntil(tStart, tNextStart, tStart, tToneEnd, 500000.0 / tEvent->Frequency, aToneSleep);
+            sleepUntil(tStart, tToneEnd, 0, 0, 0, aTimer2Sleep);
+            sleepUntil(tToneEnd, tNextStart, 0, 0, 0, aTimer2Sleep);
+        } else {
+            sleepUntil(tStart, tNextStart, 0, 0, 0, aToneSleep);
+            sleepUntil(tStart, tNextStart, 0, 0, 0, aTimer2Sleep);
+        }
+    }
+    aToneSleep->Micros = sEventBuffer[aNumberOfEvents - 1].Micros - sEventBuffer[0].Micros;
+    aTimer2Sleep->Micros = aToneSleep->Micros;
+}
+
+static double getMilliampere(struct powerEstimate *aEstimate) {
+    return IDLE_MILLIAMPERE + (ACTIVE_MILLIAMPERE - IDLE_MILLIAMPERE) * aEstimate->ActiveMicros / aEstimate->Micros;
+}
+
+static void addPowerEstimate(struct powerEstimate *aTotal, struct powerEstimate *aEstimate) {
+    aTotal->Wakeups += aEstimate->Wakeups;
+    aTotal->Updates += aEstimate->Updates;
+    aTotal->ActiveMicros += aEstimate->ActiveMicros;
+    aTotal->Micros += aEstimate->Micros;
+}
+
+/*
+ * Plays the song like playRtttlBlockingLowPowerPGM() and checks, that the notes start at the same time as in the first run.
+ * Returns the number of calls to updatePlayRtttl() or 0 if the trace is different.
+ */
+static uint32_t playSongWithSleep(const char *aSongPGM, uint32_t aNumberOfEvents) {
+    uint32_t tUpdates = 1; // the first one in start
+    setPlayRtttlUpdateFromInterrupt(false);
+    startSong(aSongPGM);
+    while (updatePlayRtttl()) {
+        tUpdates++;
+        sleepUntilPlayRtttlNextAction();
+    }
+    if (hostGetNumberOfEvents() != aNumberOfEvents) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < aNumberOfEvents && i < EVENT_BUFFER_SIZE; ++i) {
+        if (sLatencyEventBuffer[i].Micros != sEventBuffer[i].Micros) {
+            return 0;
+        }
+    }
+    return tUpdates;
+}
+
+/*
+ * Returns the number of calls to updatePlayRtttl() of the busy loop of playRtttlBlocking()
+ */
+static uint32_t playSongBusyLoop(const char *aSongPGM) {
+    uint32_t tUpdates = 1;
+    setPlayRtttlUpdateFromInterrupt(false);
+    startSong(aSongPGM);
+    while (updatePlayRtttl()) {
+        tUpdates++;
+        delay(1);
+    }
+    return tUpdates;
+}
+
+static void benchmarkSong(const char *aSongPGM, uint32_t aRepetitions, uint64_t aStartMicros, bool aPrintTrace,
+        uint64_t *aTotalNanos, uint32_t *aTotalNotes, uint64_t *aTotalSimulatedMicros) {
+    char tName[17];
+    getRtttlNamePGM(aSongPGM, tName, sizeof(tName));
+    if (sUseCompiled && convertRtttlToCompiledPGM(aSongPGM, sCompiledBuffer, COMPILED_BUFFER_SIZE) == 0) {
+        printf("%-16s cannot be converted to compiled format\n", tName);
+        return;
+    }
+
+    /*
+     * First run records the trace
+     */
+    hostSetMicros(aStartMicros);
+    hostStartRecording(sEventBuffer, EVENT_BUFFER_SIZE);
+    uint64_t tSimulatedMicros = playSong(aSongPGM);
+    uint32_t tNumberOfNotes = hostGetNumberOfEvents() - 1; // minus the noTone() of stopPlayRtttl()
+    if (aPrintTrace) {
+        printf("# %s\n", tName);
+        hostPrintEvents(stdout);
+    }
+
+    hostStartRecording(nullptr, 0);
+    uint64_t tStartNanos = getNanoseconds();
+    for (uint32_t i = 0; i < aRepetitions; ++i) {
+        hostSetMicros(aStartMicros);
+        playSong(aSongPGM);
+    }
+    uint64_t tNanos = getNanoseconds() - tStartNanos;
+
+    printf("%-16s notes=%4u simulated=%7.3f s %6.1f ns/note", tName, tNumberOfNotes, tSimulatedMicros / 1000000.0,
+            (double) tNanos / ((double) tNumberOfNotes * aRepetitions));
+
+    /*
+     * The values of getRtttlInfoPGM() must match the first run
+     */
+    struct rtttlInfo tInfo;
+    tStartNanos = getNanoseconds();
+    for (uint32_t i = 0; i < aRepetitions; ++i) {
+        getRtttlInfoPGM(aSongPGM, &tInfo);
+    }
+    sInfoNanos += getNanoseconds() - tStartNanos;
+    if (tInfo.NumberOfLoops != 0) {
+        int64_t tDurationDifference = (int64_t) tInfo.DurationMillis * 1000 - (int64_t) tSimulatedMicros;
+        if ((uint32_t) tInfo.NumberOfNotes * tInfo.NumberOfLoops != tNumberOfNotes
+                || llabs(tDurationDifference) > 500 * tInfo.NumberOfLoops) {
+            printf(" getRtttlInfoPGM() differs: notes=%u loops=%u duration=%u ms", tInfo.NumberOfNotes, tInfo.NumberOfLoops,
+                    tInfo.DurationMillis);
+        }
+    }
+
+    if (sMaximumLoopBlockingMicros != 0) {
+        /*
+         * Play again with loop latency and compare the note starts with the ones of the first run
+         */
+        hostSetMicros(aStartMicros);
+        hostStartRecording(sLatencyEventBuffer, EVENT_BUFFER_SIZE);
+#if defined(USE_RTTTL_STATISTICS)
+        sPlayRtttlState.Statistics = sLoopLatencyStatistics;
+        playSongWithLoopLatency(aSongPGM);
+        sLoopLatencyStatistics = sPlayRtttlState.Statistics;
+#else
+        playSongWithLoopLatency(aSongPGM);
+#endif
+        uint32_t tEndDelayMicros = (hostGetMicros() - aStartMicros) - tSimulatedMicros;
+        sSumOfEndDelayMicros += tEndDelayMicros;
+        if (sMaximumEndDelayMicros < tEndDelayMicros) {
+            sMaximumEndDelayMicros = tEndDelayMicros;
+        }
+        uint16_t tNumberOfDroppedNotes = getPlayRtttlNumberOfDroppedNotes();
+        sNumberOfShortenedNotes += getPlayRtttlNumberOfShortenedNotes();
+        sNumberOfDroppedNotes += tNumberOfDroppedNotes;
+        printf(" shortened=%3u dropped=%3u end delay=%7u us", getPlayRtttlNumberOfShortenedNotes(), tNumberOfDroppedNotes,
+                tEndDelayMicros);
+        if (hostGetNumberOfEvents() - 1 + tNumberOfDroppedNotes != tNumberOfNotes) {
+            printf(" different number of notes=%u with loop latency", hostGetNumberOfEvents() - 1);
+        } else if (tNumberOfDroppedNotes == 0) {
+            // The note starts can only be compared if no note was dropped
+            double tSumOfLateness = 0;
+            uint32_t tMaximumLateness = 0;
+            for (uint32_t i = 0; i < tNumberOfNotes && i < EVENT_BUFFER_SIZE; ++i) {
+                uint32_t tLateness = sLatencyEventBuffer[i].Micros - sEventBuffer[i].Micros;
+                tSumOfLateness += tLateness;
+                sSumOfSquaredLateness += (double) tLateness * tLateness;
+                if (tMaximumLateness < tLateness) {
+                    tMaximumLateness = tLateness;
+                }
+                sNumberOfLatenessValues++;
+            }
+            printf(" lateness mean=%6.0f max=%6u us", tSumOfLateness / tNumberOfNotes, tMaximumLateness);
+            sSumOfLateness += tSumOfLateness;
+            if (sMaximumLateness < tMaximumLateness) {
+                sMaximumLateness = tMaximumLateness;
+            }
+        }
+    }
+    if (sCheckSeek) {
+        /*
+         * Seek to 1/8 to 7/8 of the song and measure the time of seeking to 7/8
+         */
+        struct rtttlSeekIndex tSeekIndex;
+        buildRtttlSeekIndexPGM(aSongPGM, &tSeekIndex);
+        for (uint8_t i = 1; i < 8; ++i) {
+            uint32_t tOffsetMillis = tSimulatedMicros * i / 8000;
+            hostSetMicros(aStartMicros);
+            bool tWithoutIndexOK = checkSeek(aSongPGM, sEventBuffer, tNumberOfNotes + 1, nullptr, tOffsetMillis);
+            hostSetMicros(aStartMicros);
+            // the index is made for RTTTL text
+            bool tWithIndexOK = sUseCompiled || sUsePacked || checkSeek(aSongPGM, sEventBuffer, tNumberOfNotes + 1, &tSeekIndex, tOffsetMillis);
+            if (!tWithoutIndexOK || !tWithIndexOK) {
+                printf(" wrong trace after seek to %u ms %s index", tOffsetMillis, tWithoutIndexOK ? "with" : "without");
+            }
+        }
+        hostStartRecording(nullptr, 0);
+        uint32_t tOffsetMillis = tSimulatedMicros * 7 / 8000;
+        // Seeking may change the number of loops, so start the song before each seek and subtract the time for start
+        hostSetMicros(aStartMicros);
+        tStartNanos = getNanoseconds();
+        for (uint32_t i = 0; i < aRepetitions; ++i) {
+            startSong(aSongPGM);
+        }
+        uint64_t tStartSongNanos = getNanoseconds() - tStartNanos;
+        for (uint8_t tUseIndex = 0; tUseIndex < ((sUseCompiled || sUsePacked) ? 1 : 2); ++tUseIndex) {
+            tStartNanos = getNanoseconds();
+            for (uint32_t i = 0; i < aRepetitions; ++i) {
+                startSong(aSongPGM);
+                seekPlayRtttl(tOffsetMillis, tUseIndex ? &tSeekIndex : nullptr);
+            }
+            int64_t tSeekNanos = (int64_t) (getNanoseconds() - tStartNanos - tStartSongNanos);
+            printf(" seek %s index=%6.0f ns", tUseIndex ? "with" : "without", (double) tSeekNanos / aRepetitions);
+        }
+        stopPlayRtttl();
+    }
+    if (sCheckPushPop) {
+        uint32_t tOffsetMicros = tSimulatedMicros / 3;
+        hostSetMicros(aStartMicros);
+        if (!checkPushPop(aSongPGM, sEventBuffer, tNumberOfNotes + 1, tOffsetMicros)) {
+            printf(" wrong trace after push and pop at %u ms", tOffsetMicros / 1000);
+        }
+    }
+    if (sEstimatePower) {
+        /*
+         * Busy loop of playRtttlBlocking() compared with sleeping between the notes
+         */
+        hostSetMicros(aStartMicros);
+        hostStartRecording(nullptr, 0);
+        uint32_t tBusyLoopUpdates = playSongBusyLoop(aSongPGM);
+        sBusyLoopUpdates += tBusyLoopUpdates;
+
+        hostSetMicros(aStartMicros);
+        hostStartRecording(sLatencyEventBuffer, EVENT_BUFFER_SIZE);
+        uint32_t tSleepUpdates = playSongWithSleep(aSongPGM, tNumberOfNotes + 1);
+        if (tSleepUpdates == 0) {
+            printf(" different trace with sleepUntilPlayRtttlNextAction()");
+        }
+
+        struct powerEstimate tToneSleep = { 0, 0, 0, 0 };
+        struct powerEstimate tTimer2Sleep = { 0, 0, 0, 0 };
+        estimatePower(tNumberOfNotes + 1, &tToneSleep, &tTimer2Sleep);
+        printf(" updates busy=%6u sleep=%4u | wakeups tone()=%7llu Timer2=%6llu", tBusyLoopUpdates, tSleepUpdates,
+                (unsigned long long) tToneSleep.Wakeups, (unsigned long long) tTimer2Sleep.Wakeups);
+        addPowerEstimate(&sToneSleepTotal, &tToneSleep);
+        addPowerEstimate(&sTimer2SleepTotal, &tTimer2Sleep);
+    }
+    printf("\n");
+    *aTotalNanos += tNanos;
+    *aTotalNotes += tNumberOfNotes;
+    *aTotalSimulatedMicros += tSimulatedMicros;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t tRepetitions = 100;
+    uint64_t tStartMicros = 0;
+    bool tPrintTrace = false;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "cmktpsur:o:l:i:d:")) != -1) {
+        switch (tOption) {
+        case 'c':
+            sUseCompiled = true;
+            break;
+        case 'm':
+            sUseRAM = true;
+            break;
+        case 'k':
+            sUsePacked = true;
+            break;
+        case 't':
+            tPrintTrace = true;
+            break;
+        case 'p':
+            sEstimatePower = true;
+            break;
+        case 's':
+            sCheckSeek = true;
+            break;
+        case 'u':
+            sCheckPushPop = true;
+            break;
+        case 'r':
+            tRepetitions = strtoul(optarg, nullptr, 0);
+            break;
+        case 'o':
+            tStartMicros = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            sMaximumLoopBlockingMicros = strtoul(optarg, nullptr, 0) * 1000;
+            break;
+        case 'i':
+            sInterruptPeriodMicros = strtoul(optarg, nullptr, 0);
+            break;
+        case 'd':
+            sLatePolicy = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-c | -m | -k] [-t] [-p] [-s] [-u] [-r <repetitions>] [-o <start time in microseconds>] [-l <maximum loop blocking ms> [-i <period in us>] [-d <late policy>]]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (tRepetitions == 0) {
+        tRepetitions = 1;
+    }
+    if (sCheckSeek && !checkSeekWithEmptyIndex()) {
+        printf("Seeking with the index of an empty song does not return false\n");
+        return 1;
+    }
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    if (sCheckSeek && !checkSeekMaximumOffset()) {
+        printf("Seeking behind RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS does not return false\n");
+        return 1;
+    }
+#endif
+    if (sLatePolicy > RTTTL_LATE_POLICY_DROP) {
+        fprintf(stderr, "Late policy must be 0 to 2\n");
+        return 1;
+    }
+    setPlayRtttlLatePolicy(sLatePolicy);
+
+    /*
+     * All songs of PlayRtttl.h. RTTTLMelodiesSmall and RTTTLMelodiesTiny are subsets of RTTTLMelodies.
+     * InvalidOctave checks that octaves outside 3 to 7 in the header are replaced by DEFAULT_OCTAVE.
+     */
+    static const char InvalidOctave[] = "InvalidOctave:d=4,o=9,b=160:c,e,g,c7";
+    const char *tSongs[ARRAY_SIZE_MELODIES + ARRAY_SIZE_CHRISTMAS_MELODIES + 3];
+    uint8_t tNumberOfSongs = 0;
+    for (uint8_t i = 0; i < ARRAY_SIZE_MELODIES; ++i) {
+        tSongs[tNumberOfSongs++] = RTTTLMelodies[i];
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE_CHRISTMAS_MELODIES; ++i) {
+        tSongs[tNumberOfSongs++] = RTTTLChristmasMelodies[i];
+    }
+    tSongs[tNumberOfSongs++] = Short;
+    tSongs[tNumberOfSongs++] = Down;
+    tSongs[tNumberOfSongs++] = InvalidOctave;
+
+    if (sUsePacked) {
+        struct rtttlPackedSizes tSizes;
+        if (!packRtttlSongs(tSongs, tNumberOfSongs, &sPackedBank, &tSizes)) {
+            printf("Song %u cannot be packed\n", tSizes.NumberOfSongs);
+            return 1;
+        }
+    }
+
+    uint64_t tTotalNanos = 0;
+    uint32_t tTotalNotes = 0;
+    uint64_t tTotalSimulatedMicros = 0;
+    for (uint8_t i = 0; i < tNumberOfSongs; ++i) {
+        sPackedSongIndex = i;
+        benchmarkSong(tSongs[i], tRepetitions, tStartMicros, tPrintTrace, &tTotalNanos, &tTotalNotes, &tTotalSimulatedMicros);
+    }
+    printf("Total %u songs notes=%u simulated=%.3f s %.1f ns/note (%s)\n", tNumberOfSongs, tTotalNotes,
+            tTotalSimulatedMicros / 1000000.0, (double) tTotalNanos / ((double) tTotalNotes * tRepetitions),
+            sUseCompiled ? "compiled" : (sUseRAM ? "RTTTL text in RAM" : (sUsePacked ? "packed" : "RTTTL text")));
+    printf("getRtttlInfoPGM() %.1f ns/note\n", (double) sInfoNanos / ((double) tTotalNotes * tRepetitions));
+    if (sEstimatePower) {
+        double tSeconds = sToneSleepTotal.Micros / 1000000.0;
+        printf("Busy loop of playRtttlBlocking():   %7.1f updates/s, CPU active 100 %%, %.1f mA\n", sBusyLoopUpdates / tSeconds,
+                ACTIVE_MILLIAMPERE);
+        printf("Idle sleep with tone():             %7.1f wakeups/s, CPU active %4.1f %%, %.2f mA (estimated)\n",
+                sToneSleepTotal.Wakeups / tSeconds, 100.0 * sToneSleepTotal.ActiveMicros / sToneSleepTotal.Micros,
+                getMilliampere(&sToneSleepTotal));
+        printf("Idle sleep with direct Timer2:      %7.1f wakeups/s, CPU active %4.1f %%, %.2f mA (estimated)\n",
+                sTimer2SleepTotal.Wakeups / tSeconds, 100.0 * sTimer2SleepTotal.ActiveMicros / sTimer2SleepTotal.Micros,
+                getMilliampere(&sTimer2SleepTotal));
+        printf("Model: ATmega328P 16 MHz 5 V, active %.1f mA, idle %.1f mA, %u us per wakeup, %u us per note\n", ACTIVE_MILLIAMPERE,
+                IDLE_MILLIAMPERE, WAKEUP_ACTIVE_MICROS, UPDATE_ACTIVE_MICROS);
+    }
+    if (sNumberOfLatenessValues != 0) {
+        double tMean = sSumOfLateness / sNumberOfLatenessValues;
+        double tVariance = sSumOfSquaredLateness / sNumberOfLatenessValues - tMean * tMean;
+        printf("Note start lateness for loop blocking up to %u ms, played by %s: mean=%.0f us jitter(stddev)=%.0f us max=%u us\n",
+                sMaximumLoopBlockingMicros / 1000, sInterruptPeriodMicros != 0 ? "timer interrupt" : "loop", tMean,
+                sqrt(tVariance > 0 ? tVariance : 0), sMaximumLateness);
+    }
+    if (sMaximumLoopBlockingMicros != 0) {
+        const char *tPolicyNames[] = { "shift", "shorten", "drop" };
+        printf("Late policy %s: shortened notes=%u dropped notes=%u end of song delay mean=%.0f us max=%u us\n",
+                tPolicyNames[sLatePolicy], sNumberOfShortenedNotes, sNumberOfDroppedNotes,
+                (double) sSumOfEndDelayMicros / tNumberOfSongs, sMaximumEndDelayMicros);
+    }
+#if defined(USE_RTTTL_STATISTICS)
+    // For shift and drop, the library measures the lateness against the shifted timeline or only for the notes played
+    if (sMaximumLoopBlockingMicros != 0 && sLatePolicy == RTTTL_LATE_POLICY_SHORTEN) {
+        sPlayRtttlState.Statistics = sLoopLatencyStatistics;
+        printf("Statistics of the library:\n");
+        printPlayRtttlStatistics(&Serial);
+        if (sLoopLatencyStatistics.NumberOfNotes != sNumberOfLatenessValues
+                || sLoopLatencyStatistics.SumOfLatenessMicros != (uint32_t) sSumOfLateness
+                || sLoopLatencyStatistics.MaximumLatenessMicros != sMaximumLateness) {
+            printf("Statistics of the library differ from the measured lateness\n");
+            return 1;
+        }
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * RtttlCompilerCheck.cpp
+ *
+ * Checks that RTTTL_COMPILE() of PlayRtttlCompiler.h gives the same words as convertRtttlToCompiled() for all songs
+ * of PlayRtttl.h and for some songs using the header values and note syntax not used by them.
+ * The errors of the build time compiler are checked by static_assert, so this file does not compile if they are not detected.
+ *
+ * Usage: RtttlCompilerCheck [-v]
+ *   -v  Print the number of words of each song
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <unistd.h>
+
+#include "PlayRtttl.hpp"
+
+#define COMPILED_BUFFER_SIZE    512
+
+/*
+ * Songs for the syntax not used by the songs of PlayRtttl.h
+ */
+static const char HeaderDefaults[] = "HeaderDefaults::c,d,e";
+static const char HeaderOrder[] = "HeaderOrder:b=200,o=6,d=8:c,4d.,e5.,16p";
+static const char SharpAndDots[] = "SharpAndDots:d=4,o=4,b=120:c#,8d_.,f#.5,2g#5.,b#,b#7,h,1p.";
+static const char LoopsAndStyle[] = "LoopsAndStyle:d=4,o=5,b=100,s=S,l=3:c,e,g";
+static const char Forever[] = "Forever:d=4,o=5,b=100,s=N,l=15:c";
+static const char ManyLoops[] = "ManyLoops:d=4,o=5,b=100,s=7,l=255:c";
+static const char Empty[] = "Empty:d=4,o=5,b=100:";
+static const char InvalidOctave[] = "InvalidOctave:d=4,o=9,b=160:c,e,g,c7"; // is played in DEFAULT_OCTAVE
+
+/*
+ * Errors must be found at build time
+ */
+static_assert(RtttlCompiler::compile("NoNameEnd", nullptr).Error == RTTTL_COMPILER_ERROR_NO_NAME_END, "");
+static_assert(RtttlCompiler::compile("NoHeaderEnd:d=4", nullptr).Error == RTTTL_COMPILER_ERROR_NO_HEADER_END, "");
+static_assert(RtttlCompiler::compile("InvalidBPM:b=65536:c", nullptr).Error == RTTTL_COMPILER_ERROR_INVALID_BPM, "");
+static_assert(RtttlCompiler::compile("InvalidNote:d=4:x", nullptr).Error == RTTTL_COMPILER_ERROR_INVALID_NOTE, "");
+static_assert(RtttlCompiler::compile("InvalidDuration:d=4:3c", nullptr).Error == RTTTL_COMPILER_ERROR_INVALID_DURATION, "");
+static_assert(RtttlCompiler::compile("NoComma:d=4:c;d", nullptr).Error == RTTTL_COMPILER_ERROR_NO_COMMA, "");
+#if !defined(USE_NO_RTX_EXTENSIONS)
+static_assert(RtttlCompiler::compile("InvalidLoops:l=256:c", nullptr).Error == RTTTL_COMPILER_ERROR_INVALID_LOOPS, "");
+static_assert(RtttlCompiler::compile("MaximumLoops:l=255:c", nullptr).Error == RTTTL_COMPILER_OK, "");
+#endif
+
+struct compiledSong {
+    const char *RTTTLString;
+    const uint16_t *Words;
+    uint16_t NumberOfWords;
+};
+
+#define COMPILED_SONG(aRTTTLString) [] { \
+    static constexpr auto tCompiled = RTTTL_COMPILE(aRTTTLString); \
+    return compiledSong { aRTTTLString, tCompiled.Words, sizeof(tCompiled.Words) / sizeof(uint16_t) }; \
+}()
+
+static const struct compiledSong sCompiledSongs[] = {
+        // All songs of PlayRtttl.h
+        COMPILED_SONG(StarWars), COMPILED_SONG(MahnaMahna), COMPILED_SONG(LeisureSuit), COMPILED_SONG(MissionImp),
+        COMPILED_SONG(Entertainer), COMPILED_SONG(Muppets), COMPILED_SONG(Flinstones), COMPILED_SONG(YMCA),
+        COMPILED_SONG(Simpsons), COMPILED_SONG(Indiana), COMPILED_SONG(TakeOnMe), COMPILED_SONG(Looney),
+        COMPILED_SONG(_20thCenFox), COMPILED_SONG(Bond), COMPILED_SONG(GoodBad), COMPILED_SONG(PinkPanther),
+        COMPILED_SONG(A_Team), COMPILED_SONG(Jeopardy), COMPILED_SONG(Gadget), COMPILED_SONG(Smurfs), COMPILED_SONG(Toccata),
+        COMPILED_SONG(Short), COMPILED_SONG(Down), COMPILED_SONG(IHaveADream), COMPILED_SONG(MammaMia),
+        COMPILED_SONG(JingleBell), COMPILED_SONG(Rudolph), COMPILED_SONG(WeWishYou), COMPILED_SONG(WinterWonderland),
+        COMPILED_SONG(OhDennenboom), COMPILED_SONG(LetItSnow), COMPILED_SONG(Frosty), COMPILED_SONG(SilentNight),
+        COMPILED_SONG(LastChristmas), COMPILED_SONG(AllIWant), COMPILED_SONG(AmazingGrace),
+        // Syntax not used by them
+        COMPILED_SONG(HeaderDefaults), COMPILED_SONG(HeaderOrder), COMPILED_SONG(SharpAndDots), COMPILED_SONG(LoopsAndStyle),
+        COMPILED_SONG(Forever), COMPILED_SONG(ManyLoops), COMPILED_SONG(Empty), COMPILED_SONG(InvalidOctave) };
+
+uint16_t sCompiledBuffer[COMPILED_BUFFER_SIZE];
+
+/*
+ * Returns true if the words of RTTTL_COMPILE() are identical to the words of convertRtttlToCompiled()
+ */
+static bool checkCompiledSong(const struct compiledSong *aSong, bool aVerbose) {
+    uint16_t tNumberOfWords = convertRtttlToCompiled(aSong->RTTTLString, sCompiledBuffer, COMPILED_BUFFER_SIZE);
+    if (aVerbose) {
+        printf("%-20.*s words=%3u\n", (int) (strchr(aSong->RTTTLString, ':') - aSong->RTTTLString), aSong->RTTTLString,
+                aSong->NumberOfWords);
+    }
+    if (tNumberOfWords != aSong->NumberOfWords) {
+        printf("%s: RTTTL_COMPILE() gives %u words, convertRtttlToCompiled() %u\n", aSong->RTTTLString, aSong->NumberOfWords,
+                tNumberOfWords);
+        return false;
+    }
+    for (uint16_t i = 0; i < tNumberOfWords; ++i) {
+        if (sCompiledBuffer[i] != aSong->Words[i]) {
+            printf("%s: word %u of RTTTL_COMPILE() is 0x%04X, of convertRtttlToCompiled() 0x%04X\n", aSong->RTTTLString, i,
+                    aSong->Words[i], sCompiledBuffer[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    bool tVerbose = false;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "v")) != -1) {
+        switch (tOption) {
+        case 'v':
+            tVerbose = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint8_t tNumberOfErrors = 0;
+    for (const struct compiledSong &tSong : sCompiledSongs) {
+        if (!checkCompiledSong(&tSong, tVerbose)) {
+            tNumberOfErrors++;
+        }
+    }
+    if (tNumberOfErrors != 0) {
+        printf("RTTTL_COMPILE() differs from convertRtttlToCompiled() for %u songs\n", tNumberOfErrors);
+        return 1;
+    }
+    printf("RTTTL_COMPILE() and convertRtttlToCompiled() are identical for %u songs\n",
+            (unsigned) (sizeof(sCompiledSongs) / sizeof(sCompiledSongs[0])));
+    return 0;
+}
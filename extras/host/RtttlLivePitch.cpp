@@ -0,0 +1,236 @@
+/*
+ * RtttlLivePitch.cpp
+ *
+ * Checks setLivePitch() and setLiveNote() with the model of Timer2 in HostTimer2.h and compares them with the register writes
+ * of tone() of the Arduino AVR core. The pitch is changed at random times and phases, like by a sensor.
+ * For each change, the half period of the output, which contains the change, is checked and the latency is measured,
+ * i.e. the time from the call until the output starts its first half period with the new frequency.
+ * Phase continuous means, that this half period is not shorter than the shorter and not longer than the longer of the old and new half period.
+ * If the prescaler changes, the elapsed part of the half period is converted to the new prescaler,
+ * so one timer clock of the bigger prescaler is tolerated.
+ *
+ * Usage: RtttlLivePitch [-n <number of changes>]
+ * Returns 1 if setLivePitch() or setLiveNote() gives a glitch or a wrong frequency, or setLiveNote() does not limit note index and octave.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <unistd.h>
+
+#include "HostTimer2.h" // before PlayRtttl.hpp, which uses Timer2 if TCCR2A is defined
+#define USE_DIRECT_TIMER2_OUTPUT // for RtttlTimer2Table used by setLiveNote()
+#include "PlayRtttl.hpp"
+
+#define CYCLES_PER_MICROSECOND  (F_CPU / 1000000UL)
+#define MINIMUM_CHANGE_MICROS   1000
+#define MAXIMUM_CHANGE_MICROS   50000
+
+#define MODE_LIVE_PITCH     0
+#define MODE_LIVE_NOTE      1
+#define MODE_ARDUINO_TONE   2
+
+/*
+ * The register writes of tone() of the Arduino AVR core for Timer2, after the first call initialized the timer.
+ * The pin is toggled by hardware, as PlayRtttl does for pin 11 and 3, instead of by the interrupt of the core.
+ */
+static void toneOfArduinoCore(uint16_t aFrequency) {
+    static const uint16_t sPrescalers[] = { 1, 8, 32, 64, 128, 256, 1024 };
+    uint8_t tPrescalerBits = 0;
+    uint32_t tCompare;
+    do {
+        tCompare = F_CPU / aFrequency / 2 / sPrescalers[tPrescalerBits] - 1;
+        tPrescalerBits++;
+    } while (tCompare > 255 && tPrescalerBits < 7);
+    TCCR2B = (TCCR2B & 0b11111000) | tPrescalerBits;
+    OCR2A = tCompare;
+}
+
+struct livePitchResult {
+    uint32_t NumberOfChanges;
+    uint32_t NumberOfGlitches;
+    uint32_t NumberOfWrongHalfPeriods;
+    uint64_t SumOfLatencyCycles;
+    uint64_t MaximumLatencyCycles;
+    double MaximumTransitionRatio; // half period containing the change / longer of old and new half period
+};
+
+/*
+ * Half period in CPU cycles for the current register values
+ */
+static uint32_t getHalfPeriodCycles() {
+    return getHostTimer2Prescaler() * (sHostTimer2.CompareA + 1UL);
+}
+
+static void runLivePitch(uint8_t aMode, uint8_t aTonePin, uint32_t aNumberOfChanges, struct livePitchResult *aResult) {
+    memset(aResult, 0, sizeof(*aResult));
+    sHostTimer2 = hostTimer2();
+    sRtttlLivePitch = rtttlLivePitch();
+    srand(42);
+    if (aMode == MODE_ARDUINO_TONE) {
+        // Initialization by toneBegin() and the first tone()
+        TCCR2A = _BV(WGM21) | (aTonePin == 11 ? _BV(COM2A0) : _BV(COM2B0));
+        TCCR2B = 1;
+        toneOfArduinoCore(440);
+    } else {
+        setLivePitch(aTonePin, 440);
+    }
+
+    std::vector<uint64_t> tChangeCycles;
+    std::vector<uint32_t> tEdgeIndexOfChange; // index of the first edge after the change
+    std::vector<uint32_t> tHalfPeriodCycles; // half period after the change
+    std::vector<uint16_t> tPrescalers;
+    tChangeCycles.push_back(sHostTimer2.Cycles);
+    tEdgeIndexOfChange.push_back(0);
+    tHalfPeriodCycles.push_back(getHalfPeriodCycles());
+    tPrescalers.push_back(getHostTimer2Prescaler());
+    for (uint32_t i = 0; i < aNumberOfChanges; ++i) {
+        uint64_t tCycles = (MINIMUM_CHANGE_MICROS + random(MAXIMUM_CHANGE_MICROS - MINIMUM_CHANGE_MICROS)) * CYCLES_PER_MICROSECOND
+                + random(CYCLES_PER_MICROSECOND);
+        hostTimer2AdvanceCycles(tCycles);
+        tChangeCycles.push_back(sHostTimer2.Cycles);
+        tEdgeIndexOfChange.push_back(sHostTimer2.EdgeCycles.size());
+        if (aMode == MODE_LIVE_NOTE) {
+            setLiveNote(aTonePin, random(12), 4 + random(4));
+        } else {
+            // Every second change is a pentatonic note, the others are continuous values like tLightValue * 4 of LightToTone
+            uint16_t tFrequency =
+                    (i & 1) ? NoteC5ToC7Pentatonic[random(ARRAY_SIZE_NOTE_C5_TO_C7_PENTATONIC)] : 100 + random(4000);
+            if (aMode == MODE_ARDUINO_TONE) {
+                toneOfArduinoCore(tFrequency);
+            } else {
+                setLivePitch(aTonePin, tFrequency);
+            }
+        }
+        tHalfPeriodCycles.push_back(getHalfPeriodCycles());
+        tPrescalers.push_back(getHostTimer2Prescaler());
+    }
+    hostTimer2AdvanceCycles(MAXIMUM_CHANGE_MICROS * CYCLES_PER_MICROSECOND);
+    tEdgeIndexOfChange.push_back(sHostTimer2.EdgeCycles.size());
+
+    /*
+     * Check the half periods between and at the changes
+     */
+    std::vector<uint64_t> &tEdges = sHostTimer2.EdgeCycles;
+    // Range of the half periods since the last edge, more than 2 if there was no edge between changes
+    uint32_t tShorter = tHalfPeriodCycles[0];
+    uint32_t tLonger = tShorter;
+    uint32_t tTolerance = 0;
+    for (uint32_t i = 1; i <= aNumberOfChanges; ++i) {
+        uint32_t tNewHalfPeriod = tHalfPeriodCycles[i];
+        if (tShorter > tNewHalfPeriod) {
+            tShorter = tNewHalfPeriod;
+        }
+        if (tLonger < tNewHalfPeriod) {
+            tLonger = tNewHalfPeriod;
+        }
+        if (tPrescalers[i - 1] != tPrescalers[i]) {
+            uint16_t tBiggerPrescaler = tPrescalers[i - 1] < tPrescalers[i] ? tPrescalers[i] : tPrescalers[i - 1];
+            if (tTolerance < tBiggerPrescaler) {
+                tTolerance = tBiggerPrescaler;
+            }
+        }
+        uint32_t tFirstEdge = tEdgeIndexOfChange[i];
+        uint32_t tEndEdge = tEdgeIndexOfChange[i + 1];
+        if (tFirstEdge >= tEndEdge) {
+            continue; // next change came before the next edge
+        }
+        aResult->NumberOfChanges++;
+        uint64_t tTransition = tEdges[tFirstEdge] - tEdges[tFirstEdge - 1];
+        if (tTransition + tTolerance < tShorter || tTransition > tLonger + tTolerance) {
+            aResult->NumberOfGlitches++;
+        }
+        double tRatio = (double) tTransition / tLonger;
+        if (aResult->MaximumTransitionRatio < tRatio) {
+            aResult->MaximumTransitionRatio = tRatio;
+        }
+        uint64_t tLatency = tEdges[tFirstEdge] - tChangeCycles[i];
+        aResult->SumOfLatencyCycles += tLatency;
+        if (aResult->MaximumLatencyCycles < tLatency) {
+            aResult->MaximumLatencyCycles = tLatency;
+        }
+        for (uint32_t j = tFirstEdge + 1; j < tEndEdge; ++j) {
+            if (tEdges[j] - tEdges[j - 1] != tNewHalfPeriod) {
+                aResult->NumberOfWrongHalfPeriods++;
+            }
+        }
+        tShorter = tNewHalfPeriod;
+        tLonger = tNewHalfPeriod;
+        tTolerance = 0;
+    }
+}
+
+static void printResult(const char *aName, struct livePitchResult *aResult) {
+    printf("%-26s %6u %8u %9.1f %8.1f %10.2f\n", aName, aResult->NumberOfChanges, aResult->NumberOfGlitches,
+            (double) aResult->SumOfLatencyCycles / aResult->NumberOfChanges / CYCLES_PER_MICROSECOND,
+            (double) aResult->MaximumLatencyCycles / CYCLES_PER_MICROSECOND, aResult->MaximumTransitionRatio);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t tNumberOfChanges = 2000;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "n:")) != -1) {
+        switch (tOption) {
+        case 'n':
+            tNumberOfChanges = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n <number of changes>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("Model of Timer2 at %lu MHz, %u pitch changes after 1 to 50 ms\n", F_CPU / 1000000UL, tNumberOfChanges);
+    printf("                           changes glitches latency mean/max us  longest transition / longer half period\n");
+    struct livePitchResult tResult;
+    uint32_t tNumberOfErrors = 0;
+    runLivePitch(MODE_LIVE_PITCH, 11, tNumberOfChanges, &tResult);
+    printResult("setLivePitch() OC2A pin 11", &tResult);
+    tNumberOfErrors += tResult.NumberOfGlitches + tResult.NumberOfWrongHalfPeriods;
+    runLivePitch(MODE_LIVE_PITCH, 3, tNumberOfChanges, &tResult);
+    printResult("setLivePitch() OC2B pin 3", &tResult);
+    tNumberOfErrors += tResult.NumberOfGlitches + tResult.NumberOfWrongHalfPeriods;
+    runLivePitch(MODE_LIVE_NOTE, 11, tNumberOfChanges, &tResult);
+    printResult("setLiveNote() OC2A pin 11", &tResult);
+    tNumberOfErrors += tResult.NumberOfGlitches + tResult.NumberOfWrongHalfPeriods;
+    runLivePitch(MODE_ARDUINO_TONE, 11, tNumberOfChanges, &tResult);
+    printResult("tone() of Arduino AVR core", &tResult);
+
+    if (tNumberOfErrors != 0) {
+        printf("setLivePitch() or setLiveNote() gave %u glitches or wrong half periods\n", tNumberOfErrors);
+        return 1;
+    }
+    printf("setLivePitch() and setLiveNote() are phase continuous\n");
+
+    /*
+     * Invalid note index is ignored and the octave is limited, so the frequency does not overflow
+     */
+    setLiveNote(11, 9, 4);
+    setLiveNote(11, 12, 4);
+    uint16_t tFrequencyAfterInvalidNote = sRtttlLivePitch.Frequency;
+    setLiveNote(11, 11, 0xFF);
+    uint16_t tFrequencyOfHighestNote = sRtttlLivePitch.Frequency;
+    stopLivePitch();
+    if (tFrequencyAfterInvalidNote != 440 || tFrequencyOfHighestNote != (NOTE_B7 << (RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE - NOTES_OCTAVE))) {
+        printf("setLiveNote() gave %u Hz for note index 12 and %u Hz for octave 255\n", tFrequencyAfterInvalidNote,
+                tFrequencyOfHighestNote);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * RtttlMixer.cpp
+ *
+ * Plays "Frere Jacques" as canon with up to 4 players by USE_MIXER_OUTPUT and writes the PWM duty cycles as WAV file.
+ * The mixer interrupt handler of the library is called for each sample, the players are updated between the samples,
+ * like the loop would do. Additionally prints the pitch error of the phase increments of all notes.
+ * The cycles of the interrupt are the estimate of the library documentation, since they cannot be measured on the host.
+ *
+ * Usage: RtttlMixer [-v <number of voices>] [-o <WAV file>]
+ * Returns 1 if a player did not get its voice or a player more than the number of voices got one.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unistd.h>
+#include <vector>
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+/*
+ * Timer1 registers of the ATmega328 used by RtttlOutputMixer
+ */
+uint8_t sHostTCCR1A;
+uint8_t sHostTCCR1B;
+uint16_t sHostICR1;
+uint16_t sHostOCR1A;
+uint16_t sHostOCR1B;
+uint8_t sHostTIMSK1;
+uint8_t sHostSREG;
+#define TCCR1A  sHostTCCR1A
+#define TCCR1B  sHostTCCR1B
+#define ICR1    sHostICR1
+#define OCR1A   sHostOCR1A
+#define OCR1B   sHostOCR1B
+#define TIMSK1  sHostTIMSK1
+#define SREG    sHostSREG
+#define cli()
+#define WGM11   1
+#define WGM12   3
+#define WGM13   4
+#define CS10    0
+#define COM1B0  4
+#define COM1B1  5
+#define COM1A0  6
+#define COM1A1  7
+#define TOIE1   0
+#define NOT_ON_TIMER    0
+#define TIMER1A         1
+#define TIMER1B         2
+// OC1A is pin 9 and OC1B is pin 10 on Uno and Nano
+#define digitalPinToTimer(aPin) ((aPin) == 9 ? TIMER1A : ((aPin) == 10 ? TIMER1B : NOT_ON_TIMER))
+
+#define USE_MIXER_OUTPUT
+#if !defined(RTTTL_MIXER_NUMBER_OF_VOICES)
+#define RTTTL_MIXER_NUMBER_OF_VOICES 4
+#endif
+#include "PlayRtttl.hpp"
+#include "RtttlPcmRenderer.h"
+
+#define MIXER_PIN               9
+#define CANON_DELAY_MICROS      4000000 // 2 bars at 120 BPM
+#define ISR_CYCLES_WITHOUT_VOICES 51    // see the estimate at handleRtttlMixerSample()
+#define ISR_CYCLES_PER_VOICE    16
+#define MAXIMUM_MIXER_MICROS    (120 * 1000000ULL)
+
+#define TYPICAL_FIRST_OCTAVE    4 // RTTTL songs mostly use octave 4 to 7
+#define TYPICAL_LAST_OCTAVE     7
+
+const char FrereJacques[] PROGMEM
+= "FrereJacques:d=4,o=5,b=120,l=2:c,d,e,c,c,d,e,c,e,f,2g,e,f,2g,8g,8a,8g,8f,e,c,8g,8a,8g,8f,e,c,c,g4,2c,c,g4,2c";
+
+RtttlPlayer sVoices[RTTTL_MIXER_NUMBER_OF_VOICES + 1]; // one more to check that it gets no voice
+
+/*
+ * Prints the pitch error of the phase increments, which are the only source of pitch error of the mixer
+ */
+static void printPitchError() {
+    double tSumOfAbsoluteCent = 0;
+    double tMaximumAbsoluteCent = 0;
+    double tMaximumAbsoluteCentAll = 0;
+    uint16_t tCount = 0;
+    for (uint8_t tOctave = 0; tOctave < 10; ++tOctave) {
+        for (uint8_t tNote = 0; tNote < 12; ++tNote) {
+            // exact equal temperament frequency, A4 = 440 Hz
+            double tExactFrequency = 440.0 * pow(2.0, ((tOctave - 4) * 12 + tNote - 9) / 12.0);
+            if (tExactFrequency > RTTTL_MIXER_SAMPLE_RATE / 2) {
+                continue;
+            }
+            double tFrequency = getRtttlPhaseIncrement(tNote, tOctave) * (double) RTTTL_MIXER_SAMPLE_RATE / 65536;
+            double tAbsoluteCent = fabs(1200.0 * log2(tFrequency / tExactFrequency));
+            if (tMaximumAbsoluteCentAll < tAbsoluteCent) {
+                tMaximumAbsoluteCentAll = tAbsoluteCent;
+            }
+            if (tOctave >= TYPICAL_FIRST_OCTAVE && tOctave <= TYPICAL_LAST_OCTAVE) {
+                tSumOfAbsoluteCent += tAbsoluteCent;
+                if (tMaximumAbsoluteCent < tAbsoluteCent) {
+                    tMaximumAbsoluteCent = tAbsoluteCent;
+                }
+                tCount++;
+            }
+        }
+    }
+    printf("Pitch error octave 4 to 7 mean |error|=%.2f cent max |error|=%.2f cent, all notes below %u Hz max |error|=%.2f cent\n",
+            tSumOfAbsoluteCent / tCount, tMaximumAbsoluteCent, RTTTL_MIXER_SAMPLE_RATE / 2, tMaximumAbsoluteCentAll);
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t tNumberOfVoices = 3;
+    const char *tFileName = nullptr;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "v:o:")) != -1) {
+        switch (tOption) {
+        case 'v':
+            tNumberOfVoices = strtoul(optarg, nullptr, 0);
+            break;
+        case 'o':
+            tFileName = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-v <number of voices>] [-o <WAV file>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tNumberOfVoices < 1 || tNumberOfVoices > RTTTL_MIXER_NUMBER_OF_VOICES) {
+        fprintf(stderr, "Number of voices must be between 1 and %u\n", RTTTL_MIXER_NUMBER_OF_VOICES);
+        return 1;
+    }
+
+    printf("Mixer for F_CPU=%lu Hz, %u Hz sample rate, PWM TOP=%lu, %u voices compiled, %u voice amplitude\n", (unsigned long) F_CPU,
+    RTTTL_MIXER_SAMPLE_RATE, (unsigned long) RTTTL_PWM_TOP, RTTTL_MIXER_NUMBER_OF_VOICES, RTTTL_MIXER_VOICE_AMPLITUDE);
+    printPitchError();
+
+    /*
+     * Play the canon, the voices start one after the other
+     */
+    std::vector<int16_t> tSamples;
+    uint32_t tNumberOfErrors = 0;
+    uint8_t tNumberOfStartedVoices = 0;
+    uint64_t tCycles = 0;
+    uint64_t tNumberOfInterrupts = 0;
+    uint16_t tMaximumDuty = 0;
+    hostSetMicros(0);
+    while (true) {
+        if (tNumberOfStartedVoices < tNumberOfVoices && hostGetMicros() >= tNumberOfStartedVoices * (uint64_t) CANON_DELAY_MICROS) {
+            sVoices[tNumberOfStartedVoices].startPGM(MIXER_PIN, FrereJacques);
+            if (sVoices[tNumberOfStartedVoices].State.MixerVoiceIndex == RTTTL_MIXER_NO_VOICE) {
+                printf("Voice %u got no voice of the mixer\n", tNumberOfStartedVoices);
+                tNumberOfErrors++;
+            }
+            tNumberOfStartedVoices++;
+        }
+        bool tIsPlaying = false;
+        for (uint8_t i = 0; i < tNumberOfStartedVoices; ++i) {
+            tIsPlaying |= sVoices[i].update();
+        }
+        if (!tIsPlaying && tNumberOfStartedVoices == tNumberOfVoices) {
+            break;
+        }
+        if (hostGetMicros() > MAXIMUM_MIXER_MICROS) {
+            printf("Canon did not end\n");
+            tNumberOfErrors++;
+            break;
+        }
+        if (TIMSK1 & _BV(TOIE1)) {
+            handleRtttlMixerSample();
+            tNumberOfInterrupts++;
+        }
+        if (tMaximumDuty < OCR1A) {
+            tMaximumDuty = OCR1A;
+        }
+        // The duty cycle of 0 to 255 as 16 bit sample
+        tSamples.push_back(((int16_t) OCR1A - 128) * 128);
+        // Next sample, the time is rounded to whole microseconds
+        uint64_t tMicros = tCycles * 1000000 / F_CPU;
+        tCycles += RTTTL_PWM_TOP + 1;
+        hostAdvanceMicros(tCycles * 1000000 / F_CPU - tMicros);
+    }
+
+    // All voices are used by the canon, if it has the maximum number of voices, so one more player must get no voice
+    if (tNumberOfVoices == RTTTL_MIXER_NUMBER_OF_VOICES) {
+        for (uint8_t i = 0; i < tNumberOfVoices; ++i) {
+            sVoices[i].startPGM(MIXER_PIN, FrereJacques);
+        }
+        sVoices[tNumberOfVoices].startPGM(MIXER_PIN, FrereJacques);
+        if (sVoices[tNumberOfVoices].State.MixerVoiceIndex != RTTTL_MIXER_NO_VOICE) {
+            printf("Player %u got a voice, but all %u voices are used\n", tNumberOfVoices + 1, RTTTL_MIXER_NUMBER_OF_VOICES);
+            tNumberOfErrors++;
+        }
+        for (uint8_t i = 0; i <= tNumberOfVoices; ++i) {
+            sVoices[i].stop();
+        }
+    }
+
+    uint32_t tIsrCycles = ISR_CYCLES_WITHOUT_VOICES + ISR_CYCLES_PER_VOICE * RTTTL_MIXER_NUMBER_OF_VOICES;
+    printf("Canon with %u voices %.3f s, %llu samples, interrupt active for %llu samples, maximum duty %u of %lu\n", tNumberOfVoices,
+            hostGetMicros() / 1000000.0, (unsigned long long) tSamples.size(), (unsigned long long) tNumberOfInterrupts, tMaximumDuty,
+            (unsigned long) RTTTL_PWM_TOP + 1);
+    printf("Estimated %u cycles per interrupt = %.1f %% CPU while playing\n", tIsrCycles,
+            100.0 * tIsrCycles / (RTTTL_PWM_TOP + 1));
+    if (tFileName != nullptr) {
+        if (!writePcmWavFile(tFileName, tSamples.data(), tSamples.size(), RTTTL_MIXER_SAMPLE_RATE)) {
+            printf("Cannot write %s\n", tFileName);
+            return 1;
+        }
+        printf("Written to %s\n", tFileName);
+    }
+    return tNumberOfErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/*
+ * RtttlOutputRecorder.h
+ *
+ * Output backend for the host, which records the calls of start() and silence() as events, without using tone().
+ * It is an example for an own backend and checks, that the output goes only through RTTTL_OUTPUT.
+ * The recorded trace must be identical to the trace of the default RtttlOutputTone backend, see make check-recorder.
+ *
+ * Build with: -DRTTTL_OUTPUT=RtttlOutputRecorder -include RtttlOutputRecorder.h
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#ifndef _RTTTL_OUTPUT_RECORDER_H
+#define _RTTTL_OUTPUT_RECORDER_H
+
+#include <Arduino.h>
+#define SUPPRESS_HPP_WARNING
+#include "PlayRtttl.h"
+
+struct RtttlOutputRecorder {
+    static void begin(struct playRtttlState *aState) {
+        (void) aState;
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        hostRecordEvent(HOST_EVENT_TONE, aState->TonePin, aNote->Frequency, aNote->DurationOfTone);
+    }
+    static void silence(struct playRtttlState *aState) {
+        hostRecordEvent(HOST_EVENT_NO_TONE, aState->TonePin, 0, 0);
+    }
+};
+
+#endif // _RTTTL_OUTPUT_RECORDER_H
@@ -0,0 +1,249 @@
+/*
+ * RtttlPack.cpp
+ *
+ * Packs RTTTL songs into a bank for startPlayRtttlPackedPGM() and writes it as PROGMEM array to a header file.
+ * Reports the size of the RTTTL text, the compiled format and the bank and checks, that each song of the bank
+ * gives the same tone() / noTone() trace as its RTTTL text.
+ *
+ * Usage: RtttlPack [-a | -f <file>] [-n <array name>] [-o <header file>]
+ *   -a  Pack all songs of PlayRtttl.h instead of the 21 songs of RTTTLMelodies
+ *   -f  Pack the songs of this file, one RTTTL string per line
+ *   -n  Name of the array, default RTTTLMelodiesPacked
+ *   -o  Write the header file, default is only to report the sizes
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "PlayRtttl.hpp"
+#include "RtttlPacker.h"
+
+#define TONE_PIN                11
+#define EVENT_BUFFER_SIZE       4096
+#define MAXIMUM_SONG_MICROS     (600 * 1000000ULL) // Stop songs, which loop forever, after 10 minutes
+#define ATTINY85_FLASH_BYTES    8192
+
+struct hostEvent sTextEventBuffer[EVENT_BUFFER_SIZE];
+struct hostEvent sPackedEventBuffer[EVENT_BUFFER_SIZE];
+
+static uint64_t getNanoseconds() {
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return (uint64_t) tTime.tv_sec * 1000000000ULL + tTime.tv_nsec;
+}
+
+/*
+ * Plays the started song in virtual time and returns the number of recorded events
+ */
+static uint32_t playToEnd() {
+    while (updatePlayRtttl()) {
+        uint32_t tMicrosToWait = getPlayRtttlMicrosToNextAction();
+        hostAdvanceMicros(tMicrosToWait > 0 ? tMicrosToWait : 1);
+        if (hostGetMicros() > MAXIMUM_SONG_MICROS) {
+            stopPlayRtttl();
+            break;
+        }
+    }
+    uint32_t tNumberOfEvents = hostGetNumberOfEvents();
+    hostStartRecording(nullptr, 0);
+    if (tNumberOfEvents > EVENT_BUFFER_SIZE) {
+        tNumberOfEvents = EVENT_BUFFER_SIZE; // compare only the beginning
+    }
+    return tNumberOfEvents;
+}
+
+/*
+ * Returns true if the trace of the packed song is identical to the trace of its RTTTL text
+ */
+static bool checkPackedSong(const char *aSongPGM, const uint8_t *aBank, uint8_t aSongIndex) {
+    hostSetMicros(0);
+    hostStartRecording(sTextEventBuffer, EVENT_BUFFER_SIZE);
+    startPlayRtttlPGM(TONE_PIN, aSongPGM);
+    uint32_t tNumberOfTextEvents = playToEnd();
+
+    hostSetMicros(0);
+    hostStartRecording(sPackedEventBuffer, EVENT_BUFFER_SIZE);
+    startPlayRtttlPackedPGM(TONE_PIN, aBank, aSongIndex);
+    uint32_t tNumberOfPackedEvents = playToEnd();
+
+    if (tNumberOfTextEvents != tNumberOfPackedEvents) {
+        return false;
+    }
+    for (uint32_t i = 0; i < tNumberOfTextEvents; ++i) {
+        struct hostEvent *tText = &sTextEventBuffer[i];
+        struct hostEvent *tPacked = &sPackedEventBuffer[i];
+        if (tText->Micros != tPacked->Micros || tText->Duration != tPacked->Duration || tText->Frequency != tPacked->Frequency
+                || tText->Type != tPacked->Type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeHeader(const char *aFileName, const char *aArrayName, const std::vector<const char*> &aSongs,
+        const std::vector<uint8_t> &aBank, const struct rtttlPackedSizes *aSizes) {
+    FILE *tFile = fopen(aFileName, "w");
+    if (tFile == nullptr) {
+        return false;
+    }
+    const char *tBaseName = strrchr(aFileName, '/');
+    tBaseName = (tBaseName == nullptr) ? aFileName : tBaseName + 1;
+    fprintf(tFile, "/*\n * %s\n *\n", tBaseName);
+    fprintf(tFile, " * %u songs in the packed format for startPlayRtttlPackedPGM(), generated by extras/host/RtttlPack.\n",
+            aSizes->NumberOfSongs);
+    fprintf(tFile, " * %u bytes, RTTTL text %u bytes, compiled format %u bytes, %u phrases.\n", aSizes->BankBytes,
+            aSizes->TextBytes, aSizes->CompiledBytes, aSizes->NumberOfPhrases);
+    fprintf(tFile, " *\n * Index of the songs:\n");
+    for (uint32_t i = 0; i < aSongs.size(); ++i) {
+        char tName[17];
+        getRtttlNamePGM(aSongs[i], tName, sizeof(tName));
+        fprintf(tFile, " * %2u %s\n", i, tName);
+    }
+    fprintf(tFile, " */\n\n");
+
+    // Guard from the file name, e.g. _PLAY_RTTTL_PACKED_MELODIES_H
+    std::string tGuard;
+    for (const char *tChar = tBaseName; *tChar != '\0'; ++tChar) {
+        if (isupper(*tChar) || !isalnum(*tChar)) {
+            tGuard += '_';
+        }
+        if (isalnum(*tChar)) {
+            tGuard += (char) toupper(*tChar);
+        }
+    }
+    fprintf(tFile, "#ifndef %s\n#define %s\n\n#include <Arduino.h>\n\n", tGuard.c_str(), tGuard.c_str());
+    fprintf(tFile, "static const uint8_t %s[] PROGMEM = {", aArrayName);
+    for (uint32_t i = 0; i < aBank.size(); ++i) {
+        fprintf(tFile, "%s0x%02X%s", (i % 16 == 0) ? "\n    " : " ", aBank[i], (i + 1 < aBank.size()) ? "," : "");
+    }
+    fprintf(tFile, " };\n\n#endif // %s\n", tGuard.c_str());
+    return fclose(tFile) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool tUseAllSongs = false;
+    const char *tSongFileName = nullptr;
+    const char *tArrayName = "RTTTLMelodiesPacked";
+    const char *tHeaderFileName = nullptr;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "af:n:o:")) != -1) {
+        switch (tOption) {
+        case 'a':
+            tUseAllSongs = true;
+            break;
+        case 'f':
+            tSongFileName = optarg;
+            break;
+        case 'n':
+            tArrayName = optarg;
+            break;
+        case 'o':
+            tHeaderFileName = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-a | -f <file>] [-n <array name>] [-o <header file>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /*
+     * On the host, program memory is RAM, so the songs of a file can be used as PGM songs
+     */
+    std::vector<const char*> tSongs;
+    std::vector<std::string> tSongsOfFile;
+    if (tSongFileName != nullptr) {
+        FILE *tFile = fopen(tSongFileName, "r");
+        if (tFile == nullptr) {
+            fprintf(stderr, "Cannot open %s\n", tSongFileName);
+            return 1;
+        }
+        char tLine[4096];
+        while (fgets(tLine, sizeof(tLine), tFile) != nullptr) {
+            tLine[strcspn(tLine, "\r\n")] = '\0';
+            if (strchr(tLine, ':') != nullptr) {
+                tSongsOfFile.push_back(tLine);
+            }
+        }
+        fclose(tFile);
+        for (auto &tSong : tSongsOfFile) {
+            tSongs.push_back(tSong.c_str());
+        }
+    } else {
+        for (uint8_t i = 0; i < ARRAY_SIZE_MELODIES; ++i) {
+            tSongs.push_back(RTTTLMelodies[i]);
+        }
+        if (tUseAllSongs) {
+            for (uint8_t i = 0; i < ARRAY_SIZE_CHRISTMAS_MELODIES; ++i) {
+                tSongs.push_back(RTTTLChristmasMelodies[i]);
+            }
+            tSongs.push_back(Short);
+            tSongs.push_back(Down);
+        }
+    }
+
+    std::vector<uint8_t> tBank;
+    struct rtttlPackedSizes tSizes;
+    uint64_t tStartNanos = getNanoseconds();
+    if (!packRtttlSongs(tSongs.data(), tSongs.size(), &tBank, &tSizes)) {
+        if (tSizes.NumberOfSongs < tSongs.size()) {
+            char tName[17];
+            getRtttlNamePGM(tSongs[tSizes.NumberOfSongs], tName, sizeof(tName));
+            fprintf(stderr, "Song %u %s cannot be packed\n", tSizes.NumberOfSongs, tName);
+        } else {
+            fprintf(stderr, "Bank of %u bytes is bigger than 32 kByte\n", tSizes.BankBytes);
+        }
+        return 1;
+    }
+    uint64_t tPackNanos = getNanoseconds() - tStartNanos;
+
+    bool tAllIdentical = true;
+    for (uint32_t i = 0; i < tSongs.size(); ++i) {
+        if (!checkPackedSong(tSongs[i], tBank.data(), i)) {
+            char tName[17];
+            getRtttlNamePGM(tSongs[i], tName, sizeof(tName));
+            printf("%-16s packed trace differs from RTTTL text\n", tName);
+            tAllIdentical = false;
+        }
+    }
+
+    printf("%u songs packed in %.0f ms\n", tSizes.NumberOfSongs, tPackNanos / 1000000.0);
+    printf("RTTTL text      %6u bytes\n", tSizes.TextBytes);
+    printf("Compiled format %6u bytes %5.1f %%\n", tSizes.CompiledBytes, 100.0 * tSizes.CompiledBytes / tSizes.TextBytes);
+    printf("Nibble tokens   %6u bytes %5.1f %%\n", (tSizes.TokenNibbles + 1) / 2, 50.0 * tSizes.TokenNibbles / tSizes.TextBytes);
+    printf("Packed bank     %6u bytes %5.1f %% with %u phrases of %u bytes, compression ratio %.2f, %.1f %% of ATtiny85 flash\n",
+            tSizes.BankBytes, 100.0 * tSizes.BankBytes / tSizes.TextBytes, tSizes.NumberOfPhrases, (tSizes.PhraseNibbles + 1) / 2,
+            (double) tSizes.TextBytes / tSizes.BankBytes, 100.0 * tSizes.BankBytes / ATTINY85_FLASH_BYTES);
+    if (!tAllIdentical) {
+        return 1;
+    }
+    printf("Traces of all packed songs are identical to the traces of their RTTTL text\n");
+
+    if (tHeaderFileName != nullptr) {
+        if (!writeHeader(tHeaderFileName, tArrayName, tSongs, tBank, &tSizes)) {
+            fprintf(stderr, "Cannot write %s\n", tHeaderFileName);
+            return 1;
+        }
+        printf("Written to %s\n", tHeaderFileName);
+    }
+    return 0;
+}
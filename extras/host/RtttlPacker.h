@@ -0,0 +1,261 @@
+/*
+ * RtttlPacker.h
+ *
+ * Packs RTTTL songs into a bank for startPlayRtttlPackedPGM(), see the description of the format in PlayRtttl.h.
+ * The songs are converted to compiled format by the library and each note is then written as nibble tokens.
+ * Afterwards, the sequence of nibbles with the highest saving is repeatedly moved to the phrase dictionary and
+ * replaced in all songs by a reference, until no sequence saves space anymore or the dictionary is full.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#ifndef _RTTTL_PACKER_H
+#define _RTTTL_PACKER_H
+
+#include <Arduino.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define PACKER_COMPILED_BUFFER_SIZE 1024
+#define PACKER_MINIMUM_PHRASE_NIBBLES   4  // A reference requires 3 nibbles
+#define PACKER_MAXIMUM_PHRASE_NIBBLES   32
+#define PACKER_PHRASE_REFERENCE         16 // Symbols from 16 on are references to phrase (symbol - 16)
+
+struct rtttlPackedSizes {
+    uint32_t NumberOfSongs;     // Songs packed successfully
+    uint32_t TextBytes;         // RTTTL texts including the terminating '\0'
+    uint32_t CompiledBytes;     // The songs in compiled format
+    uint32_t TokenNibbles;      // The songs in packed format without phrases
+    uint16_t NumberOfPhrases;
+    uint32_t PhraseNibbles;     // The dictionary
+    uint32_t BankBytes;         // The complete bank
+};
+
+/*
+ * Converts the song to the 6 nibbles of the song header and the nibble tokens of the notes without end marker.
+ * Returns false, if the song cannot be converted to the compiled format or exceeds the value ranges of the packed format.
+ */
+static bool encodeRtttlSongToNibbles(const char *aSongPGM, std::vector<uint8_t> *aHeader, std::vector<int> *aTokens,
+        uint32_t *aCompiledBytes) {
+    uint16_t tCompiled[PACKER_COMPILED_BUFFER_SIZE];
+    uint16_t tNumberOfWords = convertRtttlToCompiledPGM(aSongPGM, tCompiled, PACKER_COMPILED_BUFFER_SIZE);
+    if (tNumberOfWords == 0) {
+        return false;
+    }
+    *aCompiledBytes += tNumberOfWords * sizeof(uint16_t);
+
+    uint16_t tBeatsPerMinute = tCompiled[0];
+    uint8_t tNumberOfLoops = tCompiled[1] >> 8;
+    uint8_t tStyleDivisorValue = tCompiled[1] & 0xFF;
+    if (tBeatsPerMinute > 0xFFF || tNumberOfLoops > 0xF) {
+        return false;
+    }
+    aHeader->clear();
+    aHeader->push_back(tBeatsPerMinute >> 8);
+    aHeader->push_back((tBeatsPerMinute >> 4) & 0xF);
+    aHeader->push_back(tBeatsPerMinute & 0xF);
+    aHeader->push_back(tNumberOfLoops);
+    aHeader->push_back(tStyleDivisorValue >> 4);
+    aHeader->push_back(tStyleDivisorValue & 0xF);
+
+    /*
+     * The first note always sets the duration and the first tone the octave, so a loop starts with the right values
+     */
+    aTokens->clear();
+    int tCurrentDuration = -1;
+    int tCurrentOctave = -1;
+    for (uint16_t i = RTTTL_COMPILED_HEADER_SIZE; tCompiled[i] != RTTTL_COMPILED_END; ++i) {
+        uint16_t tCompiledNote = tCompiled[i];
+        uint8_t tNote = tCompiledNote & RTTTL_COMPILED_NOTE_MASK;
+        uint8_t tOctave = (tCompiledNote >> RTTTL_COMPILED_OCTAVE_SHIFT) & RTTTL_COMPILED_OCTAVE_MASK;
+        uint8_t tDurationExponent = (tCompiledNote >> RTTTL_COMPILED_DURATION_SHIFT) & RTTTL_COMPILED_DURATION_MASK;
+        uint8_t tNumberOfDots = (tCompiledNote >> RTTTL_COMPILED_DOTS_SHIFT) & RTTTL_COMPILED_DOTS_MASK;
+        // Values after RTTTL_PACKED_DURATION and RTTTL_PACKED_OCTAVE must not be RTTTL_PACKED_ESCAPE
+        int tDuration = tDurationExponent | (tNumberOfDots * RTTTL_PACKED_DOT);
+        if (tNumberOfDots > 1 || tDuration == RTTTL_PACKED_ESCAPE || tOctave >= RTTTL_PACKED_ESCAPE) {
+            return false;
+        }
+        if (tDuration != tCurrentDuration) {
+            aTokens->push_back(RTTTL_PACKED_DURATION);
+            aTokens->push_back(tDuration);
+            tCurrentDuration = tDuration;
+        }
+        if (tNote == RTTTL_COMPILED_PAUSE) {
+            aTokens->push_back(RTTTL_PACKED_PAUSE);
+        } else {
+            if (tOctave != tCurrentOctave) {
+                aTokens->push_back(RTTTL_PACKED_OCTAVE);
+                aTokens->push_back(tOctave);
+                tCurrentOctave = tOctave;
+            }
+            aTokens->push_back(tNote);
+        }
+    }
+    return true;
+}
+
+struct phraseCandidate {
+    uint32_t Count;     // Non overlapping occurrences
+    uint32_t LastSong;
+    uint32_t EndOfLastOccurrence;
+};
+
+/*
+ * Searches the sequence of nibbles with the highest saving in all songs.
+ * Returns the saving in nibbles, which is <= 0 if no sequence saves space.
+ */
+static int findBestRtttlPhrase(const std::vector<std::vector<int>> &aSongs, std::string *aBestPhrase) {
+    int tBestSaving = 0;
+    for (uint32_t tLength = PACKER_MINIMUM_PHRASE_NIBBLES; tLength <= PACKER_MAXIMUM_PHRASE_NIBBLES; ++tLength) {
+        std::unordered_map<std::string, struct phraseCandidate> tCandidates;
+        for (uint32_t tSong = 0; tSong < aSongs.size(); ++tSong) {
+            const std::vector<int> &tSymbols = aSongs[tSong];
+            std::string tKey;
+            for (uint32_t i = 0; i + tLength <= tSymbols.size(); ++i) {
+                tKey.clear();
+                for (uint32_t j = i; j < i + tLength && tSymbols[j] < PACKER_PHRASE_REFERENCE; ++j) {
+                    tKey.push_back((char) tSymbols[j]);
+                }
+                if (tKey.size() != tLength) {
+                    continue; // contains a reference
+                }
+                struct phraseCandidate &tCandidate = tCandidates[tKey];
+                if (tCandidate.Count == 0 || tCandidate.LastSong != tSong || tCandidate.EndOfLastOccurrence <= i) {
+                    tCandidate.Count++;
+                    tCandidate.LastSong = tSong;
+                    tCandidate.EndOfLastOccurrence = i + tLength;
+                }
+            }
+        }
+        for (auto &tEntry : tCandidates) {
+            // Each occurrence saves length - 3 nibbles, the phrase requires length nibbles and 4 nibbles in the phrase table
+            int tSaving = (int) (tEntry.second.Count * (tLength - 3)) - (int) tLength - 4;
+            // Compare the phrases too, to get the same result for any order of the map
+            if (tSaving > tBestSaving || (tSaving == tBestSaving && tSaving > 0 && tEntry.first < *aBestPhrase)) {
+                tBestSaving = tSaving;
+                *aBestPhrase = tEntry.first;
+            }
+        }
+    }
+    return tBestSaving;
+}
+
+/*
+ * Replaces the non overlapping occurrences of aPhrase by the reference symbol
+ */
+static void replaceRtttlPhrase(std::vector<std::vector<int>> *aSongs, const std::string &aPhrase, int aReference) {
+    for (auto &tSymbols : *aSongs) {
+        std::vector<int> tNewSymbols;
+        uint32_t i = 0;
+        while (i < tSymbols.size()) {
+            bool tFound = i + aPhrase.size() <= tSymbols.size();
+            for (uint32_t j = 0; tFound && j < aPhrase.size(); ++j) {
+                tFound = (tSymbols[i + j] == aPhrase[j]);
+            }
+            if (tFound) {
+                tNewSymbols.push_back(aReference);
+                i += aPhrase.size();
+            } else {
+                tNewSymbols.push_back(tSymbols[i++]);
+            }
+        }
+        tSymbols = tNewSymbols;
+    }
+}
+
+static void appendNibble(std::vector<uint8_t> *aBank, uint32_t *aNibbleIndex, uint8_t aNibble) {
+    if ((*aNibbleIndex & 1) == 0) {
+        aBank->push_back(aNibble << 4);
+    } else {
+        aBank->back() |= aNibble;
+    }
+    (*aNibbleIndex)++;
+}
+
+static void setBankWord(std::vector<uint8_t> *aBank, uint32_t aByteIndex, uint16_t aValue) {
+    (*aBank)[aByteIndex] = aValue & 0xFF;
+    (*aBank)[aByteIndex + 1] = aValue >> 8;
+}
+
+/*
+ * Packs the songs into aBank. Returns false if a song cannot be packed, then aSizes->NumberOfSongs is its index,
+ * or if the bank is bigger than 32 kByte.
+ */
+static bool packRtttlSongs(const char *const aSongsPGM[], uint32_t aNumberOfSongs, std::vector<uint8_t> *aBank,
+        struct rtttlPackedSizes *aSizes) {
+    memset(aSizes, 0, sizeof(*aSizes));
+    if (aNumberOfSongs >= 0xFF) {
+        return false;
+    }
+    std::vector<std::vector<uint8_t>> tHeaders(aNumberOfSongs);
+    std::vector<std::vector<int>> tSongs(aNumberOfSongs);
+    for (uint32_t i = 0; i < aNumberOfSongs; ++i) {
+        if (!encodeRtttlSongToNibbles(aSongsPGM[i], &tHeaders[i], &tSongs[i], &aSizes->CompiledBytes)) {
+            return false;
+        }
+        aSizes->NumberOfSongs++;
+        aSizes->TextBytes += strlen(aSongsPGM[i]) + 1;
+        aSizes->TokenNibbles += RTTTL_PACKED_SONG_HEADER_NIBBLES + tSongs[i].size() + 3;
+    }
+
+    std::vector<std::string> tPhrases;
+    std::string tPhrase;
+    while (tPhrases.size() < RTTTL_PACKED_END && findBestRtttlPhrase(tSongs, &tPhrase) > 0) {
+        replaceRtttlPhrase(&tSongs, tPhrase, PACKER_PHRASE_REFERENCE + tPhrases.size());
+        tPhrases.push_back(tPhrase);
+        aSizes->PhraseNibbles += tPhrase.size();
+    }
+    aSizes->NumberOfPhrases = tPhrases.size();
+
+    /*
+     * Tables, then phrases, then songs
+     */
+    aBank->assign(2 + 2 * (aNumberOfSongs + tPhrases.size() + 1), 0);
+    (*aBank)[0] = aNumberOfSongs;
+    (*aBank)[1] = tPhrases.size();
+    uint32_t tNibbleIndex = 2 * aBank->size();
+    for (uint32_t i = 0; i < tPhrases.size(); ++i) {
+        setBankWord(aBank, 2 + 2 * (aNumberOfSongs + i), tNibbleIndex);
+        for (char tNibble : tPhrases[i]) {
+            appendNibble(aBank, &tNibbleIndex, tNibble);
+        }
+    }
+    setBankWord(aBank, 2 + 2 * (aNumberOfSongs + tPhrases.size()), tNibbleIndex);
+    for (uint32_t i = 0; i < aNumberOfSongs; ++i) {
+        setBankWord(aBank, 2 + 2 * i, tNibbleIndex);
+        for (uint8_t tNibble : tHeaders[i]) {
+            appendNibble(aBank, &tNibbleIndex, tNibble);
+        }
+        tSongs[i].push_back(PACKER_PHRASE_REFERENCE + RTTTL_PACKED_END);
+        for (int tSymbol : tSongs[i]) {
+            if (tSymbol < PACKER_PHRASE_REFERENCE) {
+                appendNibble(aBank, &tNibbleIndex, tSymbol);
+            } else {
+                appendNibble(aBank, &tNibbleIndex, RTTTL_PACKED_ESCAPE);
+                appendNibble(aBank, &tNibbleIndex, (tSymbol - PACKER_PHRASE_REFERENCE) >> 4);
+                appendNibble(aBank, &tNibbleIndex, (tSymbol - PACKER_PHRASE_REFERENCE) & 0xF);
+            }
+        }
+    }
+    aSizes->BankBytes = aBank->size();
+    return tNibbleIndex <= 0xFFFF; // nibble index must fit in 16 bit
+}
+
+#endif // _RTTTL_PACKER_H
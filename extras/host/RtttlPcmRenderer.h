@@ -0,0 +1,142 @@
+/*
+ * RtttlPcmRenderer.h
+ *
+ * Renders the tone() / noTone() events recorded by the host HAL to 16 bit mono PCM samples and writes them as WAV file.
+ * The events are generated by the library itself, so the rendered song is what updatePlayRtttl() plays,
+ * including style articulation, loops and dotted notes.
+ *
+ * Each tone() call generates the square wave of the AVR core tone(), which starts with a low half period,
+ * until the tone duration has elapsed or the next event occurs. The square wave is not band limited.
+ * The samples are computed with the vector extension of GCC and clang for 8 samples at once.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#ifndef _RTTTL_PCM_RENDERER_H
+#define _RTTTL_PCM_RENDERER_H
+
+#include <Arduino.h>
+
+#define PCM_AMPLITUDE       8192 // -12 dB full scale
+#define PCM_VECTOR_LANES    8
+
+typedef uint32_t pcmPhaseVector __attribute__((vector_size(PCM_VECTOR_LANES * sizeof(uint32_t))));
+typedef int16_t pcmSampleVector __attribute__((vector_size(PCM_VECTOR_LANES * sizeof(int16_t))));
+
+/*
+ * Converts a virtual time relative to the start of the song to a sample index
+ */
+static inline uint64_t getPcmSampleIndex(uint64_t aMicros, uint32_t aSampleRate) {
+    return (aMicros * aSampleRate + 500000) / 1000000;
+}
+
+/*
+ * Fills aSamples with a square wave, starting with phase 0, which is the start of the low half period.
+ * The phase is a 32 bit fixed point value, so the high half period is just the highest bit of the phase.
+ */
+static void renderPcmSquareWave(int16_t *aSamples, uint32_t aNumberOfSamples, uint32_t aPhaseIncrement, int16_t aAmplitude) {
+    const pcmPhaseVector tLanes = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    pcmPhaseVector tPhase = tLanes * aPhaseIncrement;
+    const uint32_t tPhaseIncrementOfVector = aPhaseIncrement * PCM_VECTOR_LANES;
+    const uint32_t tLow = (uint32_t) -aAmplitude;
+    const uint32_t tLowToHigh = 2 * (uint32_t) aAmplitude;
+
+    uint32_t i = 0;
+    for (; i + PCM_VECTOR_LANES <= aNumberOfSamples; i += PCM_VECTOR_LANES) {
+        pcmPhaseVector tSample = (tPhase >> 31) * tLowToHigh + tLow; // -aAmplitude or +aAmplitude in two's complement
+        pcmSampleVector tSample16 = __builtin_convertvector(tSample, pcmSampleVector);
+        memcpy(&aSamples[i], &tSample16, sizeof(tSample16));
+        tPhase += tPhaseIncrementOfVector;
+    }
+    // the remaining samples
+    uint32_t tPhaseOfSample = i * aPhaseIncrement;
+    for (; i < aNumberOfSamples; ++i) {
+        aSamples[i] = (int16_t) ((tPhaseOfSample >> 31) * tLowToHigh + tLow);
+        tPhaseOfSample += aPhaseIncrement;
+    }
+}
+
+/*
+ * Renders the tone events of aEvents from aStartMicros to aEndMicros to aSamples, which must have space for
+ * getPcmSampleIndex(aEndMicros - aStartMicros, aSampleRate) samples.
+ * Returns the number of samples written.
+ */
+static inline uint32_t renderRtttlEventsToPcm(const struct hostEvent *aEvents, uint32_t aNumberOfEvents, uint64_t aStartMicros,
+        uint64_t aEndMicros, uint32_t aSampleRate, int16_t *aSamples) {
+    uint32_t tNumberOfSamples = getPcmSampleIndex(aEndMicros - aStartMicros, aSampleRate);
+    memset(aSamples, 0, tNumberOfSamples * sizeof(int16_t));
+
+    for (uint32_t i = 0; i < aNumberOfEvents; ++i) {
+        const struct hostEvent *tEvent = &aEvents[i];
+        if (tEvent->Type != HOST_EVENT_TONE || tEvent->Frequency == 0) {
+            continue; // silence is already there
+        }
+        // The tone lasts until the next event or until its duration has elapsed
+        uint64_t tEndMicros = (i + 1 < aNumberOfEvents) ? aEvents[i + 1].Micros : aEndMicros;
+        if (tEvent->Duration != 0 && tEvent->Micros + tEvent->Duration * 1000ULL < tEndMicros) {
+            tEndMicros = tEvent->Micros + tEvent->Duration * 1000ULL;
+        }
+        if (tEndMicros > aEndMicros) {
+            tEndMicros = aEndMicros;
+        }
+        uint32_t tFirstSample = getPcmSampleIndex(tEvent->Micros - aStartMicros, aSampleRate);
+        uint32_t tEndSample = getPcmSampleIndex(tEndMicros - aStartMicros, aSampleRate);
+        if (tEndSample > tFirstSample) {
+            uint32_t tPhaseIncrement = (uint32_t) (((uint64_t) tEvent->Frequency << 32) / aSampleRate);
+            renderPcmSquareWave(&aSamples[tFirstSample], tEndSample - tFirstSample, tPhaseIncrement, PCM_AMPLITUDE);
+        }
+    }
+    return tNumberOfSamples;
+}
+
+static void writeLittleEndian(FILE *aFile, uint32_t aValue, uint8_t aNumberOfBytes) {
+    for (uint8_t i = 0; i < aNumberOfBytes; ++i) {
+        fputc(aValue & 0xFF, aFile);
+        aValue >>= 8;
+    }
+}
+
+/*
+ * Writes a 16 bit mono PCM WAV file. Returns false if the file cannot be written.
+ */
+static bool writePcmWavFile(const char *aFileName, const int16_t *aSamples, uint32_t aNumberOfSamples, uint32_t aSampleRate) {
+    FILE *tFile = fopen(aFileName, "wb");
+    if (tFile == nullptr) {
+        return false;
+    }
+    uint32_t tDataSize = aNumberOfSamples * sizeof(int16_t);
+    fputs("RIFF", tFile);
+    writeLittleEndian(tFile, 36 + tDataSize, 4);
+    fputs("WAVEfmt ", tFile);
+    writeLittleEndian(tFile, 16, 4); // size of fmt chunk
+    writeLittleEndian(tFile, 1, 2); // PCM
+    writeLittleEndian(tFile, 1, 2); // mono
+    writeLittleEndian(tFile, aSampleRate, 4);
+    writeLittleEndian(tFile, aSampleRate * sizeof(int16_t), 4); // bytes per second
+    writeLittleEndian(tFile, sizeof(int16_t), 2); // bytes per sample frame
+    writeLittleEndian(tFile, 16, 2); // bits per sample
+    fputs("data", tFile);
+    writeLittleEndian(tFile, tDataSize, 4);
+    for (uint32_t i = 0; i < aNumberOfSamples; ++i) {
+        writeLittleEndian(tFile, (uint16_t) aSamples[i], 2);
+    }
+    return fclose(tFile) == 0;
+}
+
+#endif // _RTTTL_PCM_RENDERER_H
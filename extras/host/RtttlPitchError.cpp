@@ -0,0 +1,179 @@
+/*
+ * RtttlPitchError.cpp
+ *
+ * Prints the pitch error in cent of all notes of octave 0 to 9 for the output with the AVR core tone() function
+ * and for USE_DIRECT_TIMER2_OUTPUT with the compile time table of PlayRtttlTimerTable.h, both using Timer2.
+ * The tone() path is modeled after Tone.cpp of the Arduino AVR core, which gets the integer frequency
+ * computed by prepareNextRtttlNote() and computes the compare value by truncating integer divisions.
+ *
+ * Usage: RtttlPitchError [-s]
+ *   -s  Print only the summary
+ * Build for another CPU frequency with: make pitch F_CPU=8000000UL
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unistd.h>
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+#define SUPPRESS_HPP_WARNING
+#include "PlayRtttl.h"
+#include "PlayRtttlTimerTable.h"
+
+#define TYPICAL_FIRST_OCTAVE    4 // RTTTL songs mostly use octave 4 to 7
+#define TYPICAL_LAST_OCTAVE     7
+#define TIMER2_MINIMUM_FREQUENCY (F_CPU / (2.0 * 1024 * 256)) // 30.5 Hz for 16 MHz
+
+static const char *const sNoteNames[] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+static const int sNotes[] = { NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7, NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7,
+NOTE_AS7, NOTE_B7 };
+
+/*
+ * Frequency generated by tone() on Timer2 of the Arduino AVR core for the integer frequency aFrequency
+ */
+static double getToneFrequency(uint16_t aFrequency) {
+    if (aFrequency == 0) {
+        return 0;
+    }
+    uint32_t tPrescaler = 1;
+    uint32_t tCompare = F_CPU / aFrequency / 2 - 1;
+    if (tCompare > 255) {
+        tPrescaler = 8;
+        tCompare = F_CPU / aFrequency / 2 / 8 - 1;
+        if (tCompare > 255) {
+            tPrescaler = 32;
+            tCompare = F_CPU / aFrequency / 2 / 32 - 1;
+        }
+        if (tCompare > 255) {
+            tPrescaler = 64;
+            tCompare = F_CPU / aFrequency / 2 / 64 - 1;
+            if (tCompare > 255) {
+                tPrescaler = 128;
+                tCompare = F_CPU / aFrequency / 2 / 128 - 1;
+            }
+            if (tCompare > 255) {
+                tPrescaler = 256;
+                tCompare = F_CPU / aFrequency / 2 / 256 - 1;
+                if (tCompare > 255) {
+                    tPrescaler = 1024;
+                    tCompare = F_CPU / aFrequency / 2 / 1024 - 1;
+                }
+            }
+        }
+    }
+    // The 8 bit register takes only the lower byte
+    return F_CPU / (2.0 * tPrescaler * (1 + (tCompare & 0xFF)));
+}
+
+static double getCent(double aFrequency, double aExactFrequency) {
+    if (aFrequency <= 0) {
+        return NAN;
+    }
+    return 1200.0 * log2(aFrequency / aExactFrequency);
+}
+
+struct centStatistics {
+    double SumOfAbsoluteCent;
+    double MaximumAbsoluteCent;
+    uint16_t Count;
+};
+
+static void addCent(struct centStatistics *aStatistics, double aCent) {
+    // NAN (no output at all) counts as maximum error
+    double tAbsoluteCent = isnan(aCent) ? 1200.0 : fabs(aCent);
+    aStatistics->SumOfAbsoluteCent += tAbsoluteCent;
+    if (aStatistics->MaximumAbsoluteCent < tAbsoluteCent) {
+        aStatistics->MaximumAbsoluteCent = tAbsoluteCent;
+    }
+    aStatistics->Count++;
+}
+
+static void printStatistics(const char *aText, struct centStatistics *aStatistics) {
+    printf("%-28s mean |error|=%6.2f cent max |error|=%7.2f cent\n", aText,
+            aStatistics->SumOfAbsoluteCent / aStatistics->Count, aStatistics->MaximumAbsoluteCent);
+}
+
+int main(int argc, char *argv[]) {
+    bool tPrintOnlySummary = false;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "s")) != -1) {
+        if (tOption == 's') {
+            tPrintOnlySummary = true;
+        } else {
+            fprintf(stderr, "Usage: %s [-s]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    struct centStatistics tToneStatistics = { 0, 0, 0 };
+    struct centStatistics tTableStatistics = { 0, 0, 0 };
+    struct centStatistics tToneTypicalStatistics = { 0, 0, 0 };
+    struct centStatistics tTableTypicalStatistics = { 0, 0, 0 };
+
+    printf("Pitch error for F_CPU=%lu Hz\n", (unsigned long) F_CPU);
+    if (!tPrintOnlySummary) {
+        printf("Note    exact Hz |  tone() Hz     cent | table Hz     cent prescaler compare\n");
+    }
+    for (uint8_t tOctave = 0; tOctave < RTTTL_TIMER2_TABLE_OCTAVES; ++tOctave) {
+        for (uint8_t tNote = 0; tNote < 12; ++tNote) {
+            // exact equal temperament frequency, A4 = 440 Hz
+            double tExactFrequency = 440.0 * pow(2.0, ((tOctave - 4) * 12 + tNote - 9) / 12.0);
+
+            // same computation as in prepareNextRtttlNote()
+            uint16_t tFrequency = sNotes[tNote];
+            if (tOctave <= NOTES_OCTAVE) {
+                tFrequency >>= (NOTES_OCTAVE - tOctave);
+            } else {
+                tFrequency <<= (tOctave - NOTES_OCTAVE);
+            }
+            double tToneFrequency = getToneFrequency(tFrequency);
+            double tToneCent = getCent(tToneFrequency, tExactFrequency);
+
+            uint16_t tEntry = RtttlTimer2Table[tOctave][tNote];
+            double tTableFrequency = getRtttlTimer2Frequency(tEntry);
+            double tTableCent = getCent(tTableFrequency, tExactFrequency);
+
+            if (tExactFrequency >= TIMER2_MINIMUM_FREQUENCY) {
+                addCent(&tToneStatistics, tToneCent);
+                addCent(&tTableStatistics, tTableCent);
+            }
+            if (tOctave >= TYPICAL_FIRST_OCTAVE && tOctave <= TYPICAL_LAST_OCTAVE) {
+                addCent(&tToneTypicalStatistics, tToneCent);
+                addCent(&tTableTypicalStatistics, tTableCent);
+            }
+            if (!tPrintOnlySummary) {
+                printf("%-2s%u %10.2f | %9.2f %8.2f | %8.2f %8.2f %9u %7u\n", sNoteNames[tNote], tOctave, tExactFrequency,
+                        tToneFrequency, tToneCent, tTableFrequency, tTableCent,
+                        getRtttlTimer2Prescaler(tEntry >> RTTTL_TIMER2_PRESCALER_SHIFT), tEntry & RTTTL_TIMER2_COMPARE_MASK);
+            }
+        }
+    }
+    printStatistics("tone() octave 4 to 7", &tToneTypicalStatistics);
+    printStatistics("Timer2 table octave 4 to 7", &tTableTypicalStatistics);
+    printf("Octave 0 to 9 without the %u notes below %.1f Hz, which Timer2 cannot generate\n",
+            RTTTL_TIMER2_TABLE_OCTAVES * 12 - tToneStatistics.Count, TIMER2_MINIMUM_FREQUENCY);
+    printStatistics("tone() all notes", &tToneStatistics);
+    printStatistics("Timer2 table all notes", &tTableStatistics);
+    return 0;
+}
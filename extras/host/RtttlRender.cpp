@@ -0,0 +1,171 @@
+/*
+ * RtttlRender.cpp
+ *
+ * Renders all included melodies to 16 bit mono PCM WAV files, e.g. to listen to them or to compare them without hardware.
+ * The songs are played by the library in virtual time and the recorded tone() and noTone() calls are rendered
+ * by RtttlPcmRenderer.h. Reports the time required for playing and rendering all songs, without writing the files.
+ *
+ * Usage: RtttlRender [-c] [-n] [-s <sample rate>] [-d <directory>]
+ *   -c  Convert songs to compiled format before playing. The files must be identical to the ones without -c.
+ *   -n  Do not write files, only measure the time for rendering
+ *   -s  Sample rate, default 44100
+ *   -d  Directory for the WAV files, default is the current directory
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "PlayRtttl.hpp"
+#include "RtttlPcmRenderer.h"
+
+#define TONE_PIN                11
+#define EVENT_BUFFER_SIZE       4096
+#define COMPILED_BUFFER_SIZE    512
+#define MAXIMUM_SONG_MICROS     (600 * 1000000ULL) // Stop songs, which loop forever, after 10 minutes
+
+struct hostEvent sEventBuffer[EVENT_BUFFER_SIZE];
+uint16_t sCompiledBuffer[COMPILED_BUFFER_SIZE];
+bool sUseCompiled = false;
+
+static uint64_t getNanoseconds() {
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return (uint64_t) tTime.tv_sec * 1000000000ULL + tTime.tv_nsec;
+}
+
+/*
+ * Plays the song in virtual time and records the events. Returns the simulated duration in microseconds.
+ */
+static uint64_t playSong(const char *aSongPGM) {
+    hostSetMicros(0);
+    hostStartRecording(sEventBuffer, EVENT_BUFFER_SIZE);
+    if (sUseCompiled) {
+        startPlayRtttlCompiled(TONE_PIN, sCompiledBuffer);
+    } else {
+        startPlayRtttlPGM(TONE_PIN, aSongPGM);
+    }
+    while (updatePlayRtttl()) {
+        // Jump directly to the next action
+        uint32_t tMicrosToWait = getPlayRtttlMicrosToNextAction();
+        hostAdvanceMicros(tMicrosToWait > 0 ? tMicrosToWait : 1);
+        if (hostGetMicros() > MAXIMUM_SONG_MICROS) {
+            stopPlayRtttl();
+            break;
+        }
+    }
+    return hostGetMicros();
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t tSampleRate = 44100;
+    const char *tDirectory = ".";
+    bool tWriteFiles = true;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "cns:d:")) != -1) {
+        switch (tOption) {
+        case 'c':
+            sUseCompiled = true;
+            break;
+        case 'n':
+            tWriteFiles = false;
+            break;
+        case 's':
+            tSampleRate = strtoul(optarg, nullptr, 0);
+            break;
+        case 'd':
+            tDirectory = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-c] [-n] [-s <sample rate>] [-d <directory>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tSampleRate < 1000) {
+        fprintf(stderr, "Sample rate %u is too low\n", tSampleRate);
+        return 1;
+    }
+
+    /*
+     * All songs of PlayRtttl.h. RTTTLMelodiesSmall and RTTTLMelodiesTiny are subsets of RTTTLMelodies.
+     */
+    const char *tSongs[ARRAY_SIZE_MELODIES + ARRAY_SIZE_CHRISTMAS_MELODIES + 2];
+    uint8_t tNumberOfSongs = 0;
+    for (uint8_t i = 0; i < ARRAY_SIZE_MELODIES; ++i) {
+        tSongs[tNumberOfSongs++] = RTTTLMelodies[i];
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE_CHRISTMAS_MELODIES; ++i) {
+        tSongs[tNumberOfSongs++] = RTTTLChristmasMelodies[i];
+    }
+    tSongs[tNumberOfSongs++] = Short;
+    tSongs[tNumberOfSongs++] = Down;
+
+    uint64_t tTotalNanos = 0;
+    uint64_t tTotalSamples = 0;
+    int16_t *tSamples = (int16_t*) malloc(getPcmSampleIndex(MAXIMUM_SONG_MICROS, tSampleRate) * sizeof(int16_t));
+    if (tSamples == nullptr) {
+        fprintf(stderr, "Not enough memory for the samples\n");
+        return 1;
+    }
+    for (uint8_t i = 0; i < tNumberOfSongs; ++i) {
+        char tName[17];
+        getRtttlNamePGM(tSongs[i], tName, sizeof(tName));
+        if (sUseCompiled && convertRtttlToCompiledPGM(tSongs[i], sCompiledBuffer, COMPILED_BUFFER_SIZE) == 0) {
+            printf("%-16s cannot be converted to compiled format\n", tName);
+            continue;
+        }
+
+        uint64_t tStartNanos = getNanoseconds();
+        uint64_t tSongMicros = playSong(tSongs[i]);
+        uint32_t tNumberOfEvents = hostGetNumberOfEvents();
+        if (tNumberOfEvents > EVENT_BUFFER_SIZE) {
+            printf("%-16s has more than %u events\n", tName, EVENT_BUFFER_SIZE);
+            continue;
+        }
+        uint32_t tNumberOfSamples = renderRtttlEventsToPcm(sEventBuffer, tNumberOfEvents, 0, tSongMicros, tSampleRate, tSamples);
+        tTotalNanos += getNanoseconds() - tStartNanos;
+        tTotalSamples += tNumberOfSamples;
+
+        printf("%-16s %7.3f s %8u samples", tName, tSongMicros / 1000000.0, tNumberOfSamples);
+        if (tWriteFiles) {
+            // The name is the first part of the RTTTL string, so keep only characters which are safe for a file name
+            for (char *tChar = tName; *tChar != '\0'; ++tChar) {
+                if (!isalnum(*tChar)) {
+                    *tChar = '_';
+                }
+            }
+            char tFileName[256];
+            snprintf(tFileName, sizeof(tFileName), "%s/%s.wav", tDirectory, tName);
+            if (!writePcmWavFile(tFileName, tSamples, tNumberOfSamples, tSampleRate)) {
+                printf(" cannot write %s\n", tFileName);
+                free(tSamples);
+                return 1;
+            }
+            printf(" %s", tFileName);
+        }
+        printf("\n");
+    }
+    free(tSamples);
+    printf("Rendered %u songs with %.1f s audio at %u Hz in %.1f ms (%s)\n", tNumberOfSongs,
+            (double) tTotalSamples / tSampleRate, tSampleRate, tTotalNanos / 1000000.0, sUseCompiled ? "compiled" : "RTTTL text");
+    return 0;
+}
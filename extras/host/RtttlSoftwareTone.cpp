@@ -0,0 +1,263 @@
+/*
+ * RtttlSoftwareTone.cpp
+ *
+ * Measures pitch error and jitter of USE_SOFTWARE_TONE_OUTPUT for all notes.
+ * The interrupt handler of the library is called at each tick of a cycle based model of Timer1 and the edges of the pin are recorded.
+ * The model contains the Timer0 overflow interrupt of millis(), which delays the service of a tick, if the tick occurs while it is running.
+ * The cycles of the interrupts are the estimates of the library documentation and the assumed run time of the millis() interrupt,
+ * since they cannot be measured on the host.
+ *
+ * Usage: RtttlSoftwareTone [-m <cycles of millis() interrupt>] [-s]
+ * -s prints only the summary
+ * Returns 1 if a tick was lost.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unistd.h>
+#include <vector>
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+/*
+ * Timer1 registers of the ATmega328 and ATtiny167 and the port access used by RtttlOutputSoftwareTone
+ */
+uint8_t sHostTCCR1A;
+uint8_t sHostTCCR1B;
+uint16_t sHostOCR1A;
+uint16_t sHostOCR1B;
+uint8_t sHostTIFR1;
+uint8_t sHostTIMSK1;
+uint8_t sHostSREG;
+volatile uint8_t sHostPinInputRegister; // the mask written by the interrupt handler, instead of toggling the pin
+#define TCCR1A  sHostTCCR1A
+#define TCCR1B  sHostTCCR1B
+#define OCR1A   sHostOCR1A
+#define OCR1B   sHostOCR1B
+#define TIFR1   sHostTIFR1
+#define TIMSK1  sHostTIMSK1
+#define SREG    sHostSREG
+#define cli()
+#define WGM12   3
+#define CS10    0
+#define OCF1B   2
+#define OCIE1B  2
+#define digitalPinToPort(aPin)      (0)
+#define digitalPinToBitMask(aPin)   _BV((aPin) & 0x07)
+#define portInputRegister(aPort)    (&sHostPinInputRegister)
+
+#define USE_SOFTWARE_TONE_OUTPUT
+#include "PlayRtttl.hpp"
+
+#define TONE_PIN                4    // a pin of an ATtiny85 without hardware tone
+#define MEASUREMENT_CYCLES      F_CPU // one second for each note
+// Cycles of the tick interrupt, see the estimate at handleRtttlSoftwareToneTick()
+#define TICK_ISR_CYCLES         66
+#define TOGGLE_ADDITIONAL_CYCLES 23
+#define CYCLES_TO_PIN_WRITE     41   // from the interrupt request to the write of PINx, constant, so it does not change the jitter
+#define MAXIMUM_RESPONSE_DELAY  3    // cycles to complete a multi cycle instruction before the interrupt is serviced
+// Timer0 overflow interrupt for millis(), prescaler 64 and 8 below 8 MHz, like ATTinyCore does for 1 MHz
+#if F_CPU >= 8000000L
+#define MILLIS_INTERRUPT_PERIOD_CYCLES (256UL * 64)
+#else
+#define MILLIS_INTERRUPT_PERIOD_CYCLES (256UL * 8)
+#endif
+#define DEFAULT_MILLIS_INTERRUPT_CYCLES 80 // assumed run time of the millis() interrupt including response and reti
+
+#define TYPICAL_FIRST_OCTAVE    4 // RTTTL songs mostly use octave 4 to 7
+#define TYPICAL_LAST_OCTAVE     7
+
+static const char *const sNoteNames[] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+
+struct softwareToneResult {
+    double Frequency;
+    double JitterPeakToPeakCycles; // of the edges against their exact time
+    uint32_t NumberOfLostTicks;
+    uint64_t InterruptCycles;
+};
+
+/*
+ * Plays one note for MEASUREMENT_CYCLES with the library backend and returns frequency, jitter and interrupt load
+ */
+static void measureNote(uint8_t aNoteIndex, uint8_t aOctave, uint16_t aMillisInterruptCycles, struct softwareToneResult *aResult) {
+    memset(aResult, 0, sizeof(*aResult));
+    struct playRtttlState tState;
+    memset(&tState, 0, sizeof(tState));
+    tState.TonePin = TONE_PIN;
+    RtttlOutputSoftwareTone::begin(&tState);
+    struct rtttlPreparedNote tNote;
+    tNote.SoftwareToneHalfPeriod = getRtttlSoftwareToneHalfPeriod(aNoteIndex, aOctave);
+    RtttlOutputSoftwareTone::start(&tState, &tNote);
+
+    uint32_t tTickCycles = OCR1A + 1UL; // the configuration of the library
+    std::vector<uint64_t> tEdgeCycles;
+    uint64_t tCpuFreeCycles = 0;
+    uint64_t tNextMillisInterruptCycles = MILLIS_INTERRUPT_PERIOD_CYCLES / 3; // any phase to the ticks
+    srand(aNoteIndex + 12 * aOctave);
+    for (uint64_t tTickRequestCycles = tTickCycles; tTickRequestCycles < MEASUREMENT_CYCLES; tTickRequestCycles += tTickCycles) {
+        // millis() interrupts requested before this tick are serviced before
+        while (aMillisInterruptCycles > 0 && tNextMillisInterruptCycles <= tTickRequestCycles) {
+            uint64_t tStartCycles = tCpuFreeCycles > tNextMillisInterruptCycles ? tCpuFreeCycles : tNextMillisInterruptCycles;
+            tCpuFreeCycles = tStartCycles + aMillisInterruptCycles;
+            tNextMillisInterruptCycles += MILLIS_INTERRUPT_PERIOD_CYCLES;
+        }
+        uint64_t tServiceCycles = tCpuFreeCycles > tTickRequestCycles ? tCpuFreeCycles : tTickRequestCycles;
+        tServiceCycles += random(MAXIMUM_RESPONSE_DELAY);
+        if (tServiceCycles >= tTickRequestCycles + tTickCycles) {
+            // The next request came before this one was serviced, so the interrupt flag merges both
+            aResult->NumberOfLostTicks++;
+            tTickRequestCycles += tTickCycles;
+        }
+        if (!(TIMSK1 & _BV(OCIE1B))) {
+            continue;
+        }
+        sHostPinInputRegister = 0;
+        handleRtttlSoftwareToneTick();
+        uint16_t tCycles = TICK_ISR_CYCLES;
+        if (sHostPinInputRegister == digitalPinToBitMask(TONE_PIN)) {
+            tEdgeCycles.push_back(tServiceCycles + CYCLES_TO_PIN_WRITE);
+            tCycles += TOGGLE_ADDITIONAL_CYCLES;
+        }
+        tCpuFreeCycles = tServiceCycles + tCycles;
+        aResult->InterruptCycles += tCycles;
+    }
+    RtttlOutputSoftwareTone::silence(&tState);
+
+    uint32_t tNumberOfHalfPeriods = tEdgeCycles.size() - 1;
+    double tHalfPeriodCycles = (double) (tEdgeCycles.back() - tEdgeCycles.front()) / tNumberOfHalfPeriods;
+    aResult->Frequency = F_CPU / (2.0 * tHalfPeriodCycles);
+    // The exact edge times are given by the programmed half period, which is also the mean of the generated half periods
+    double tProgrammedHalfPeriodCycles = tNote.SoftwareToneHalfPeriod * (double) tTickCycles / 256;
+    double tMinimumDeviation = 0;
+    double tMaximumDeviation = 0;
+    for (uint32_t i = 1; i <= tNumberOfHalfPeriods; ++i) {
+        double tDeviation = tEdgeCycles[i] - (tEdgeCycles.front() + i * tProgrammedHalfPeriodCycles);
+        if (tMinimumDeviation > tDeviation) {
+            tMinimumDeviation = tDeviation;
+        }
+        if (tMaximumDeviation < tDeviation) {
+            tMaximumDeviation = tDeviation;
+        }
+    }
+    aResult->JitterPeakToPeakCycles = tMaximumDeviation - tMinimumDeviation;
+}
+
+struct noteStatistics {
+    double SumOfAbsoluteCent;
+    double MaximumAbsoluteCent;
+    double MaximumJitterCycles;
+    double MaximumJitterRatio; // jitter / half period
+    uint16_t Count;
+};
+
+static void addNote(struct noteStatistics *aStatistics, double aCent, double aJitterCycles, double aJitterRatio) {
+    aStatistics->SumOfAbsoluteCent += fabs(aCent);
+    if (aStatistics->MaximumAbsoluteCent < fabs(aCent)) {
+        aStatistics->MaximumAbsoluteCent = fabs(aCent);
+    }
+    if (aStatistics->MaximumJitterCycles < aJitterCycles) {
+        aStatistics->MaximumJitterCycles = aJitterCycles;
+    }
+    if (aStatistics->MaximumJitterRatio < aJitterRatio) {
+        aStatistics->MaximumJitterRatio = aJitterRatio;
+    }
+    aStatistics->Count++;
+}
+
+static void printStatistics(const char *aText, struct noteStatistics *aStatistics) {
+    printf("%-24s mean |error|=%5.2f cent max |error|=%5.2f cent max jitter=%6.1f us = %4.1f %% of half period\n", aText,
+            aStatistics->SumOfAbsoluteCent / aStatistics->Count, aStatistics->MaximumAbsoluteCent,
+            aStatistics->MaximumJitterCycles * 1000000.0 / F_CPU, aStatistics->MaximumJitterRatio * 100);
+}
+
+int main(int argc, char *argv[]) {
+    bool tPrintOnlySummary = false;
+    uint16_t tMillisInterruptCycles = DEFAULT_MILLIS_INTERRUPT_CYCLES;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "m:s")) != -1) {
+        switch (tOption) {
+        case 'm':
+            tMillisInterruptCycles = strtoul(optarg, nullptr, 0);
+            break;
+        case 's':
+            tPrintOnlySummary = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-m <cycles of millis() interrupt>] [-s]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    double tTickFrequency = (double) F_CPU / RTTTL_SOFTWARE_TONE_TICK_CYCLES;
+    printf("Software tone for F_CPU=%lu Hz, interrupt every %lu cycles = %.0f Hz, millis() interrupt of %u cycles every %lu cycles\n",
+            (unsigned long) F_CPU, (unsigned long) RTTTL_SOFTWARE_TONE_TICK_CYCLES, tTickFrequency, tMillisInterruptCycles,
+            MILLIS_INTERRUPT_PERIOD_CYCLES);
+    if (!tPrintOnlySummary) {
+        printf("Note    exact Hz |  output Hz     cent | jitter us without / with millis() | CPU %%\n");
+    }
+    struct noteStatistics tTypicalStatistics = { 0, 0, 0, 0, 0 };
+    struct noteStatistics tAllStatistics = { 0, 0, 0, 0, 0 };
+    struct noteStatistics tTypicalWithoutMillisStatistics = { 0, 0, 0, 0, 0 };
+    uint32_t tNumberOfLostTicks = 0;
+    uint16_t tNumberOfTooHighNotes = 0;
+    double tMaximumLoad = 0;
+    for (uint8_t tOctave = 0; tOctave < 10; ++tOctave) {
+        for (uint8_t tNote = 0; tNote < 12; ++tNote) {
+            // exact equal temperament frequency, A4 = 440 Hz
+            double tExactFrequency = 440.0 * pow(2.0, ((tOctave - 4) * 12 + tNote - 9) / 12.0);
+            if (tExactFrequency > tTickFrequency / 2) {
+                tNumberOfTooHighNotes++; // clamped to half of the interrupt rate
+                continue;
+            }
+            struct softwareToneResult tWithoutMillis;
+            struct softwareToneResult tWithMillis;
+            measureNote(tNote, tOctave, 0, &tWithoutMillis);
+            measureNote(tNote, tOctave, tMillisInterruptCycles, &tWithMillis);
+            tNumberOfLostTicks += tWithMillis.NumberOfLostTicks;
+            double tCent = 1200.0 * log2(tWithMillis.Frequency / tExactFrequency);
+            double tHalfPeriodCycles = F_CPU / (2.0 * tExactFrequency);
+            double tLoad = (double) tWithMillis.InterruptCycles / MEASUREMENT_CYCLES;
+            if (tMaximumLoad < tLoad) {
+                tMaximumLoad = tLoad;
+            }
+            addNote(&tAllStatistics, tCent, tWithMillis.JitterPeakToPeakCycles, tWithMillis.JitterPeakToPeakCycles / tHalfPeriodCycles);
+            if (tOctave >= TYPICAL_FIRST_OCTAVE && tOctave <= TYPICAL_LAST_OCTAVE) {
+                addNote(&tTypicalStatistics, tCent, tWithMillis.JitterPeakToPeakCycles,
+                        tWithMillis.JitterPeakToPeakCycles / tHalfPeriodCycles);
+                addNote(&tTypicalWithoutMillisStatistics, tCent, tWithoutMillis.JitterPeakToPeakCycles,
+                        tWithoutMillis.JitterPeakToPeakCycles / tHalfPeriodCycles);
+            }
+            if (!tPrintOnlySummary) {
+                printf("%-2s%u %10.2f | %9.2f %8.2f | %14.1f %15.1f | %5.1f\n", sNoteNames[tNote], tOctave, tExactFrequency,
+                        tWithMillis.Frequency, tCent, tWithoutMillis.JitterPeakToPeakCycles * 1000000.0 / F_CPU,
+                        tWithMillis.JitterPeakToPeakCycles * 1000000.0 / F_CPU, tLoad * 100);
+            }
+        }
+    }
+    printStatistics("Octave 4 to 7", &tTypicalStatistics);
+    printStatistics("Without millis()", &tTypicalWithoutMillisStatistics);
+    printf("Octave 0 to 9 without the %u notes above %.0f Hz, which are clamped to it\n", tNumberOfTooHighNotes, tTickFrequency / 2);
+    printStatistics("All notes", &tAllStatistics);
+    printf("Maximum CPU load by the interrupts of the tone %.1f %%, lost ticks %u\n", tMaximumLoad * 100, tNumberOfLostTicks);
+    return tNumberOfLostTicks == 0 ? 0 : 1;
+}
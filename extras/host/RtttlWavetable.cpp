@@ -0,0 +1,407 @@
+/*
+ * RtttlWavetable.cpp
+ *
+ * Generates ../../src/PlayRtttlWavetables.h for USE_WAVETABLE_OUTPUT and checks the backend on the host.
+ * Prints the accuracy and the harmonics of the waveforms, renders songs with all waveforms by calling the interrupt handler
+ * of the library for each sample and writes the duty cycles as WAV files.
+ * Measures the time of the interrupt handler per sample on the host and prints the estimated cycles of the AVR.
+ *
+ * Usage: RtttlWavetable [-o <header file>] [-n] [-d <directory>]
+ *   -o  Only write the tables to the header file
+ *   -n  Do not write WAV files
+ *   -d  Directory for the WAV files, default is the current directory
+ * Returns 1 if the next note cuts a release, which should end within the style gap, or if the output does not end with silence.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ */
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+/*
+ * Timer1 registers of the ATmega328 used by RtttlOutputWavetable
+ */
+uint8_t sHostTCCR1A;
+uint8_t sHostTCCR1B;
+uint16_t sHostICR1;
+uint16_t sHostOCR1A;
+uint16_t sHostOCR1B;
+uint8_t sHostTIMSK1;
+uint8_t sHostSREG;
+#define TCCR1A  sHostTCCR1A
+#define TCCR1B  sHostTCCR1B
+#define ICR1    sHostICR1
+#define OCR1A   sHostOCR1A
+#define OCR1B   sHostOCR1B
+#define TIMSK1  sHostTIMSK1
+#define SREG    sHostSREG
+#define cli()
+#define WGM11   1
+#define WGM12   3
+#define WGM13   4
+#define CS10    0
+#define COM1B0  4
+#define COM1B1  5
+#define COM1A0  6
+#define COM1A1  7
+#define TOIE1   0
+#define NOT_ON_TIMER    0
+#define TIMER1A         1
+#define TIMER1B         2
+// OC1A is pin 9 and OC1B is pin 10 on Uno and Nano
+#define digitalPinToTimer(aPin) ((aPin) == 9 ? TIMER1A : ((aPin) == 10 ? TIMER1B : NOT_ON_TIMER))
+
+#define USE_WAVETABLE_OUTPUT
+#include "PlayRtttl.hpp"
+#include "RtttlPcmRenderer.h"
+
+/*
+ * Parameters of the generated tables
+ */
+#define WAVETABLE_SIZE_SHIFT        6
+#define WAVETABLE_SIZE              (1 << WAVETABLE_SIZE_SHIFT)
+#define ATTENUATION_STEPS_PER_6_DB  16
+#define MAXIMUM_LEVEL               127
+#define SILENT_ATTENUATION          128  // Number of levels
+#define ATTACK_STEPS                5    // Linear rise of the amplitude in about 5 ms
+#define DECAY_STEPS                 48   // Exponential decay to the sustain level in about 48 ms
+#define SUSTAIN_ATTENUATION         16   // -6 dB
+
+#define WAVETABLE_PIN               9
+#define MAXIMUM_SONG_MICROS         (120 * 1000000ULL)
+#define MAXIMUM_RELEASE_MICROS      200000
+#define BENCHMARK_SAMPLES           20000000
+// Cycles of the interrupt, see the estimate at handleRtttlWavetableSample()
+#define ISR_CYCLES                  110
+#define ENVELOPE_STEP_CYCLES        25
+
+static const char *const sWaveformNames[RTTTL_NUMBER_OF_WAVEFORMS] = { "sine", "triangle", "pulse50", "pulse25", "pulse12" };
+
+static uint64_t getNanoseconds() {
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return (uint64_t) tTime.tv_sec * 1000000000ULL + tTime.tv_nsec;
+}
+
+/*
+ * Value between -1 and 1 of the waveform at aPhase between 0 and 1. The pulse waves have no DC component, so the
+ * envelope does not modulate a DC offset, which would be audible as a click.
+ */
+static double getWaveformValue(uint8_t aWaveform, double aPhase) {
+    switch (aWaveform) {
+    case RTTTL_WAVEFORM_SINE:
+        return sin(2 * M_PI * aPhase);
+    case RTTTL_WAVEFORM_TRIANGLE:
+        return (aPhase < 0.25) ? 4 * aPhase : ((aPhase < 0.75) ? 2 - 4 * aPhase : 4 * aPhase - 4);
+    default:
+        double tDutyCycle = (aWaveform == RTTTL_WAVEFORM_PULSE_50) ? 0.5 : ((aWaveform == RTTTL_WAVEFORM_PULSE_25) ? 0.25 : 0.125);
+        return (aPhase < tDutyCycle) ? 1 : -tDutyCycle / (1 - tDutyCycle);
+    }
+}
+
+static uint8_t getAttenuation(double aValue) {
+    aValue = fabs(aValue);
+    if (aValue == 0) {
+        return SILENT_ATTENUATION - 1;
+    }
+    long tAttenuation = lround(-ATTENUATION_STEPS_PER_6_DB * log2(aValue));
+    return (tAttenuation > SILENT_ATTENUATION - 1) ? SILENT_ATTENUATION - 1 : tAttenuation;
+}
+
+struct wavetables {
+    uint8_t Wavetables[RTTTL_NUMBER_OF_WAVEFORMS][WAVETABLE_SIZE];
+    uint8_t Levels[SILENT_ATTENUATION];
+    std::vector<uint8_t> Envelope;
+};
+
+/*
+ * The samples are taken in the middle of each of the WAVETABLE_SIZE intervals, so the sine has no sample at its zero crossing
+ */
+static void computeWavetables(struct wavetables *aTables) {
+    for (uint8_t tWaveform = 0; tWaveform < RTTTL_NUMBER_OF_WAVEFORMS; ++tWaveform) {
+        for (uint8_t i = 0; i < WAVETABLE_SIZE; ++i) {
+            double tValue = getWaveformValue(tWaveform, (i + 0.5) / WAVETABLE_SIZE);
+            aTables->Wavetables[tWaveform][i] = getAttenuation(tValue) | ((tValue < 0) ? RTTTL_WAVETABLE_NEGATIVE : 0);
+        }
+    }
+    for (uint8_t i = 0; i < SILENT_ATTENUATION; ++i) {
+        aTables->Levels[i] = lround(MAXIMUM_LEVEL * exp2(-(double) i / ATTENUATION_STEPS_PER_6_DB));
+    }
+    aTables->Envelope.clear();
+    for (uint8_t i = 1; i <= ATTACK_STEPS; ++i) {
+        aTables->Envelope.push_back(getAttenuation((double) i / ATTACK_STEPS));
+    }
+    for (uint8_t i = 1; i <= DECAY_STEPS; ++i) {
+        aTables->Envelope.push_back(lround((double) SUSTAIN_ATTENUATION * i / DECAY_STEPS));
+    }
+}
+
+static void writeTable(FILE *aFile, const uint8_t *aTable, uint32_t aLength, const char *aIndent) {
+    for (uint32_t i = 0; i < aLength; ++i) {
+        fprintf(aFile, "%s0x%02X%s", (i % 16 == 0) ? aIndent : " ", aTable[i], (i + 1 < aLength) ? "," : "");
+    }
+}
+
+static bool writeHeader(const char *aFileName, struct wavetables *aTables) {
+    FILE *tFile = fopen(aFileName, "w");
+    if (tFile == nullptr) {
+        return false;
+    }
+    const char *tBaseName = strrchr(aFileName, '/');
+    tBaseName = (tBaseName == nullptr) ? aFileName : tBaseName + 1;
+    fprintf(tFile, "/*\n * %s\n *\n", tBaseName);
+    fprintf(tFile, " * Wavetables, output levels and envelope for USE_WAVETABLE_OUTPUT, generated by extras/host/RtttlWavetable.\n");
+    fprintf(tFile, " * A sample is RTTTL_WAVETABLE_NEGATIVE | <attenuation>, the attenuation is in steps of 6 dB / %u.\n",
+    ATTENUATION_STEPS_PER_6_DB);
+    fprintf(tFile, " * The level of an attenuation is %u * 2^(-attenuation / %u).\n", MAXIMUM_LEVEL, ATTENUATION_STEPS_PER_6_DB);
+    fprintf(tFile, " * The envelope has %u steps attack and %u steps decay to the sustain attenuation %u, one step is about 1 ms.\n",
+    ATTACK_STEPS, DECAY_STEPS, SUSTAIN_ATTENUATION);
+    fprintf(tFile, " */\n\n");
+    fprintf(tFile, "#ifndef _PLAY_RTTTL_WAVETABLES_H\n#define _PLAY_RTTTL_WAVETABLES_H\n\n#include \"PlayRtttl.h\"\n\n");
+    fprintf(tFile, "#define RTTTL_WAVETABLE_SIZE_SHIFT      %u\n", WAVETABLE_SIZE_SHIFT);
+    fprintf(tFile, "#define RTTTL_WAVETABLE_NEGATIVE        0x80\n");
+    fprintf(tFile, "#define RTTTL_WAVETABLE_ATTENUATION_MASK 0x7F\n");
+    fprintf(tFile, "#define RTTTL_WAVETABLE_SILENT          %u // Attenuation of silence, also the number of levels\n",
+    SILENT_ATTENUATION);
+    fprintf(tFile, "#define RTTTL_WAVETABLE_ATTACK_LENGTH   %u // The last step of the attack has attenuation 0\n", ATTACK_STEPS);
+    fprintf(tFile, "#define RTTTL_WAVETABLE_ENVELOPE_LENGTH %u\n\n", (unsigned) aTables->Envelope.size());
+
+    fprintf(tFile, "static const uint8_t RtttlWavetables[RTTTL_NUMBER_OF_WAVEFORMS][1 << RTTTL_WAVETABLE_SIZE_SHIFT] PROGMEM = {");
+    for (uint8_t tWaveform = 0; tWaveform < RTTTL_NUMBER_OF_WAVEFORMS; ++tWaveform) {
+        fprintf(tFile, "\n    // %s\n    {", sWaveformNames[tWaveform]);
+        writeTable(tFile, aTables->Wavetables[tWaveform], WAVETABLE_SIZE, "\n        ");
+        fprintf(tFile, " }%s", (tWaveform + 1 < RTTTL_NUMBER_OF_WAVEFORMS) ? "," : "");
+    }
+    fprintf(tFile, " };\n\n");
+    fprintf(tFile, "static const uint8_t RtttlWavetableLevels[RTTTL_WAVETABLE_SILENT] PROGMEM = {");
+    writeTable(tFile, aTables->Levels, SILENT_ATTENUATION, "\n    ");
+    fprintf(tFile, " };\n\n");
+    fprintf(tFile, "static const uint8_t RtttlWavetableEnvelope[RTTTL_WAVETABLE_ENVELOPE_LENGTH] PROGMEM = {");
+    writeTable(tFile, aTables->Envelope.data(), aTables->Envelope.size(), "\n    ");
+    fprintf(tFile, " };\n\n#endif // _PLAY_RTTTL_WAVETABLES_H\n");
+    return fclose(tFile) == 0;
+}
+
+/*
+ * Prints the maximum error of the samples of the library tables against the exact waveform
+ * and the power of all harmonics relative to the fundamental.
+ */
+static void printWaveformAccuracy() {
+    printf("Waveform  max error  harmonics\n");
+    for (uint8_t tWaveform = 0; tWaveform < RTTTL_NUMBER_OF_WAVEFORMS; ++tWaveform) {
+        double tValues[WAVETABLE_SIZE];
+        double tMaximumError = 0;
+        for (uint8_t i = 0; i < WAVETABLE_SIZE; ++i) {
+            uint8_t tSample = pgm_read_byte(&RtttlWavetables[tWaveform][i]);
+            double tLevel = pgm_read_byte(&RtttlWavetableLevels[tSample & RTTTL_WAVETABLE_ATTENUATION_MASK]);
+            tValues[i] = (tSample & RTTTL_WAVETABLE_NEGATIVE) ? -tLevel : tLevel;
+            double tError = fabs(tValues[i] - MAXIMUM_LEVEL * getWaveformValue(tWaveform, (i + 0.5) / WAVETABLE_SIZE));
+            if (tMaximumError < tError) {
+                tMaximumError = tError;
+            }
+        }
+        // Power of the harmonics by discrete Fourier transform
+        double tFundamentalPower = 0;
+        double tHarmonicsPower = 0;
+        for (uint8_t tHarmonic = 1; tHarmonic < WAVETABLE_SIZE / 2; ++tHarmonic) {
+            double tReal = 0;
+            double tImaginary = 0;
+            for (uint8_t i = 0; i < WAVETABLE_SIZE; ++i) {
+                tReal += tValues[i] * cos(2 * M_PI * tHarmonic * i / WAVETABLE_SIZE);
+                tImaginary += tValues[i] * sin(2 * M_PI * tHarmonic * i / WAVETABLE_SIZE);
+            }
+            if (tHarmonic == 1) {
+                tFundamentalPower = tReal * tReal + tImaginary * tImaginary;
+            } else {
+                tHarmonicsPower += tReal * tReal + tImaginary * tImaginary;
+            }
+        }
+        printf("%-9s %5.2f %%    %6.1f dB\n", sWaveformNames[tWaveform], 100.0 * tMaximumError / MAXIMUM_LEVEL,
+                10 * log10(tHarmonicsPower / tFundamentalPower));
+    }
+}
+
+struct wavetableSongResult {
+    uint32_t NumberOfSamples;
+    uint32_t NumberOfCutReleases;   // Releases, which were stopped by the next note
+    bool IsSilentAtEnd;
+};
+
+/*
+ * Plays the song sample by sample in virtual time, like the loop and the Timer1 interrupt would do, and stores the duty cycles
+ */
+static void renderSong(const char *aSongPGM, uint8_t aWaveform, std::vector<int16_t> &aSamples, struct wavetableSongResult *aResult) {
+    memset(aResult, 0, sizeof(*aResult));
+    aSamples.clear();
+    setRtttlWaveform(aWaveform);
+    hostSetMicros(0);
+    startPlayRtttlPGM(WAVETABLE_PIN, aSongPGM);
+    uint64_t tCycles = 0;
+    uint64_t tMicrosOfSongEnd = 0;
+    while (true) {
+        if (tMicrosOfSongEnd == 0) {
+            bool tIsReleasing = sRtttlWavetable.ReleaseStep != 0 && sRtttlWavetable.Attenuation < RTTTL_WAVETABLE_SILENT;
+            if (!updatePlayRtttl() || hostGetMicros() > MAXIMUM_SONG_MICROS) {
+                stopPlayRtttl();
+                tMicrosOfSongEnd = hostGetMicros();
+            } else if (tIsReleasing && sRtttlWavetable.ReleaseStep == 0 && sPlayRtttlState.StyleDivisorValue != 0) {
+                aResult->NumberOfCutReleases++;
+            }
+        } else if (!(TIMSK1 & _BV(TOIE1)) || hostGetMicros() - tMicrosOfSongEnd > MAXIMUM_RELEASE_MICROS) {
+            aResult->IsSilentAtEnd = !(TIMSK1 & _BV(TOIE1)) && OCR1A == RTTTL_WAVETABLE_ZERO_DUTY;
+            break;
+        }
+        if (TIMSK1 & _BV(TOIE1)) {
+            handleRtttlWavetableSample();
+        }
+        aSamples.push_back(((int16_t) OCR1A - RTTTL_WAVETABLE_ZERO_DUTY) * 256);
+        // Next sample, the time is rounded to whole microseconds
+        uint64_t tMicros = tCycles * 1000000 / F_CPU;
+        tCycles += RTTTL_PWM_TOP + 1;
+        hostAdvanceMicros(tCycles * 1000000 / F_CPU - tMicros);
+    }
+    aResult->NumberOfSamples = aSamples.size();
+}
+
+/*
+ * Calls the interrupt handler for a tone of 440 Hz with attack, decay and release every 0.5 s and returns the nanoseconds per sample
+ */
+static double measureSampleNanos(uint8_t aWaveform) {
+    struct playRtttlState tState;
+    memset(&tState, 0, sizeof(tState));
+    tState.TonePin = WAVETABLE_PIN;
+    RtttlOutputWavetable::begin(&tState);
+    setRtttlWaveform(aWaveform);
+    struct rtttlPreparedNote tNote;
+    tNote.PhaseIncrement = getRtttlPhaseIncrement(9, 4); // A4
+    tNote.WavetableReleaseStep = getRtttlWavetableReleaseStep(100000);
+    uint64_t tStartNanos = getNanoseconds();
+    for (uint32_t i = 0; i < BENCHMARK_SAMPLES; ++i) {
+        uint32_t tSampleOfTone = i % (RTTTL_WAVETABLE_SAMPLE_RATE / 2);
+        if (tSampleOfTone == 0) {
+            RtttlOutputWavetable::start(&tState, &tNote);
+        } else if (tSampleOfTone == RTTTL_WAVETABLE_SAMPLE_RATE / 4) {
+            RtttlOutputWavetable::silence(&tState);
+        }
+        handleRtttlWavetableSample();
+    }
+    uint64_t tNanos = getNanoseconds() - tStartNanos;
+    TIMSK1 &= ~_BV(TOIE1);
+    sRtttlWavetable.Attenuation = RTTTL_WAVETABLE_SILENT;
+    return (double) tNanos / BENCHMARK_SAMPLES;
+}
+
+int main(int argc, char *argv[]) {
+    const char *tHeaderFileName = nullptr;
+    const char *tDirectory = ".";
+    bool tWriteFiles = true;
+    int tOption;
+    while ((tOption = getopt(argc, argv, "o:nd:")) != -1) {
+        switch (tOption) {
+        case 'o':
+            tHeaderFileName = optarg;
+            break;
+        case 'n':
+            tWriteFiles = false;
+            break;
+        case 'd':
+            tDirectory = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-o <header file>] [-n] [-d <directory>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (tHeaderFileName != nullptr) {
+        struct wavetables tTables;
+        computeWavetables(&tTables);
+        if (!writeHeader(tHeaderFileName, &tTables)) {
+            fprintf(stderr, "Cannot write %s\n", tHeaderFileName);
+            return 1;
+        }
+        printf("Written to %s\n", tHeaderFileName);
+        return 0;
+    }
+
+    printf("Wavetable for F_CPU=%lu Hz, %u Hz sample rate, PWM TOP=%lu, envelope step %lu us\n", (unsigned long) F_CPU,
+    RTTTL_WAVETABLE_SAMPLE_RATE, (unsigned long) RTTTL_PWM_TOP, (unsigned long) RTTTL_WAVETABLE_ENVELOPE_STEP_MICROS);
+    printWaveformAccuracy();
+
+    /*
+     * Render songs with each waveform
+     */
+    const char *tSongs[] = { StarWars, Short, Down };
+    uint32_t tNumberOfErrors = 0;
+    std::vector<int16_t> tSamples;
+    for (uint8_t i = 0; i < sizeof(tSongs) / sizeof(tSongs[0]); ++i) {
+        char tName[17];
+        getRtttlNamePGM(tSongs[i], tName, sizeof(tName));
+        for (char *tChar = tName; *tChar != '\0'; ++tChar) {
+            if (!isalnum(*tChar)) {
+                *tChar = '_';
+            }
+        }
+        for (uint8_t tWaveform = 0; tWaveform < RTTTL_NUMBER_OF_WAVEFORMS; ++tWaveform) {
+            struct wavetableSongResult tResult;
+            renderSong(tSongs[i], tWaveform, tSamples, &tResult);
+            printf("%-12s %-9s %7.3f s, cut releases %u%s", tName, sWaveformNames[tWaveform],
+                    (double) tResult.NumberOfSamples / RTTTL_WAVETABLE_SAMPLE_RATE, tResult.NumberOfCutReleases,
+                    tResult.IsSilentAtEnd ? "" : ", not silent at end");
+            tNumberOfErrors += tResult.NumberOfCutReleases + (tResult.IsSilentAtEnd ? 0 : 1);
+            if (tWriteFiles) {
+                char tFileName[256];
+                snprintf(tFileName, sizeof(tFileName), "%s/%s-%s.wav", tDirectory, tName, sWaveformNames[tWaveform]);
+                if (!writePcmWavFile(tFileName, tSamples.data(), tSamples.size(), RTTTL_WAVETABLE_SAMPLE_RATE)) {
+                    printf(" cannot write %s\n", tFileName);
+                    return 1;
+                }
+                printf(" %s", tFileName);
+            }
+            printf("\n");
+        }
+    }
+
+    /*
+     * CPU load per sample
+     */
+    double tSampleMicros = 1000000.0 / RTTTL_WAVETABLE_SAMPLE_RATE;
+    for (uint8_t tWaveform = 0; tWaveform < RTTTL_NUMBER_OF_WAVEFORMS; ++tWaveform) {
+        double tNanos = measureSampleNanos(tWaveform);
+        printf("Interrupt handler on host %-9s %5.2f ns/sample = %.3f %% of the sample period\n", sWaveformNames[tWaveform], tNanos,
+                tNanos / 10 / tSampleMicros);
+    }
+    double tAverageCycles = ISR_CYCLES + (double) ENVELOPE_STEP_CYCLES / RTTTL_WAVETABLE_ENVELOPE_DIVIDER;
+    printf("Estimated %.1f cycles per sample on AVR = %.1f %% CPU while playing\n", tAverageCycles,
+            100.0 * tAverageCycles / (RTTTL_PWM_TOP + 1));
+
+    if (tNumberOfErrors != 0) {
+        printf("%u cut releases or songs without silence at end\n", tNumberOfErrors);
+        return 1;
+    }
+    return 0;
+}
@@ -38,15 +38,13 @@
 #endif
 #if defined(__AVR__)
 #include <avr/pgmspace.h>
-#endif
-#if defined(ESP32)
-#define TONE_LEDC_CHANNEL   0 // channel used for ledcWriteTone()
+#include <avr/eeprom.h>
 #endif
 #include "pitches.h"
 
-#define VERSION_PLAY_RTTTL "2.2.0"
+#define VERSION_PLAY_RTTTL "2.3.0"
 #define VERSION_PLAY_RTTTL_MAJOR 2
-#define VERSION_PLAY_RTTTL_MINOR 2
+#define VERSION_PLAY_RTTTL_MINOR 3
 #define VERSION_PLAY_RTTTL_PATCH 0
 // The change log is at the bottom of the file
 
@@ -57,12 +55,101 @@
 #define VERSION_HEX_VALUE(major, minor, patch) ((major << 16) | (minor << 8) | (patch))
 #define VERSION_PLAY_RTTTL_HEX  VERSION_HEX_VALUE(VERSION_PLAY_RTTTL_MAJOR, VERSION_PLAY_RTTTL_MINOR, VERSION_PLAY_RTTTL_PATCH)
 
+//#define USE_NO_DURATION_TABLE // Computes the durations for each note with 2 divisions instead of a table lookup. Saves 96 bytes RAM.
+//#define USE_DIRECT_TIMER2_OUTPUT // Notes on the OC2A and OC2B pins are started by writing precomputed values to Timer2 instead of calling tone(). Requires 240 bytes FLASH for the table.
+#if defined(USE_DIRECT_TIMER2_OUTPUT) && !defined(TCCR2A)
+#warning USE_DIRECT_TIMER2_OUTPUT requires an AVR with Timer2, tone() is used instead.
+#undef USE_DIRECT_TIMER2_OUTPUT
+#endif
+//#define USE_PWM_OUTPUT // Generates the tone with analogWrite() at 50 % duty cycle. For the Teensy and the RP2040 core of Earle Philhower.
+//#define USE_SOFTWARE_TONE_OUTPUT // Toggles any pin by a fixed rate interrupt of Timer1 with precomputed half periods, e.g. for pins of an ATtiny85 without hardware tone.
+#if defined(USE_SOFTWARE_TONE_OUTPUT) && !defined(TCCR1A) && !defined(TCCR1)
+#warning USE_SOFTWARE_TONE_OUTPUT requires an AVR with Timer1, tone() is used instead.
+#undef USE_SOFTWARE_TONE_OUTPUT
+#endif
+#if defined(USE_SOFTWARE_TONE_OUTPUT) && !defined(RTTTL_SOFTWARE_TONE_TICK_CYCLES)
+#  if F_CPU >= 8000000L
+#define RTTTL_SOFTWARE_TONE_TICK_CYCLES (F_CPU / 20000L) // 20 kHz interrupt rate, the ISR requires 8 to 11 % CPU at 16 MHz
+#  else
+#define RTTTL_SOFTWARE_TONE_TICK_CYCLES 200 // 5 kHz interrupt rate at 1 MHz, the highest tone is 2.5 kHz
+#  endif
+#endif
+//#define USE_MIXER_OUTPUT // Mixes the songs of up to 4 players to one PWM pin of Timer1, e.g. for chords and two-part melodies. See RtttlOutputMixer.
+#if defined(USE_MIXER_OUTPUT) && !defined(ICR1)
+#warning USE_MIXER_OUTPUT requires an AVR with the 16 bit Timer1, tone() is used instead.
+#undef USE_MIXER_OUTPUT
+#endif
+#if defined(USE_MIXER_OUTPUT)
+#  if !defined(RTTTL_MIXER_NUMBER_OF_VOICES)
+#define RTTTL_MIXER_NUMBER_OF_VOICES    2 // 2 to 4 players can be mixed, each voice costs 16 cycles in the ISR
+#  endif
+#  if RTTTL_MIXER_NUMBER_OF_VOICES < 2 || RTTTL_MIXER_NUMBER_OF_VOICES > 4
+#error RTTTL_MIXER_NUMBER_OF_VOICES must be 2, 3 or 4
+#  endif
+#  if !defined(RTTTL_MIXER_SAMPLE_RATE)
+#define RTTTL_MIXER_SAMPLE_RATE         31250 // PWM frequency and rate of the ISR, which requires 16 to 22 % CPU at 16 MHz
+#  endif
+#define RTTTL_MIXER_NO_VOICE            0xFF // MixerVoiceIndex of a player, if all voices are used by other players
+#endif
+//#define USE_WAVETABLE_OUTPUT // Plays the notes with a sine, triangle or pulse wavetable and a volume envelope on one PWM pin of Timer1. See RtttlOutputWavetable.
+#if defined(USE_WAVETABLE_OUTPUT) && !defined(ICR1)
+#warning USE_WAVETABLE_OUTPUT requires an AVR with the 16 bit Timer1, tone() is used instead.
+#undef USE_WAVETABLE_OUTPUT
+#endif
+#if defined(USE_WAVETABLE_OUTPUT)
+#  if defined(USE_MIXER_OUTPUT)
+#error USE_WAVETABLE_OUTPUT and USE_MIXER_OUTPUT cannot be used together, both use Timer1
+#  endif
+#  if !defined(RTTTL_WAVETABLE_SAMPLE_RATE)
+#define RTTTL_WAVETABLE_SAMPLE_RATE     31250 // PWM frequency and rate of the ISR, which requires about 22 % CPU at 16 MHz
+#  endif
+#endif
+// Only one output can be selected, the other ones would be silently ignored by the selection of RTTTL_OUTPUT below
+#if defined(USE_SOFTWARE_TONE_OUTPUT) && (defined(USE_MIXER_OUTPUT) || defined(USE_WAVETABLE_OUTPUT))
+#error USE_SOFTWARE_TONE_OUTPUT cannot be used together with USE_MIXER_OUTPUT or USE_WAVETABLE_OUTPUT, all use Timer1
+#endif
+#if defined(USE_DIRECT_TIMER2_OUTPUT) && (defined(USE_SOFTWARE_TONE_OUTPUT) || defined(USE_MIXER_OUTPUT) || defined(USE_WAVETABLE_OUTPUT))
+#error USE_DIRECT_TIMER2_OUTPUT cannot be used together with USE_SOFTWARE_TONE_OUTPUT, USE_MIXER_OUTPUT or USE_WAVETABLE_OUTPUT
+#endif
+
+/*
+ * The output backend. It is a struct with the static functions begin(), start() and silence(), see RtttlOutputTone in PlayRtttl.hpp.
+ * To use your own backend, include PlayRtttl.h, define your backend struct and RTTTL_OUTPUT to its name,
+ * and then include PlayRtttl.hpp.
+ * Define RTTTL_OUTPUT_HAS_NO_TONE_DURATION if start() cannot stop the tone by itself after the duration of the tone,
+ * then silence() is called by updatePlayRtttl() at end of the tone.
+ */
+#if !defined(RTTTL_OUTPUT)
+#  if defined(USE_DIRECT_TIMER2_OUTPUT)
+#define RTTTL_OUTPUT RtttlOutputTimer2
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  elif defined(USE_SOFTWARE_TONE_OUTPUT)
+#define RTTTL_OUTPUT RtttlOutputSoftwareTone
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  elif defined(USE_MIXER_OUTPUT)
+#define RTTTL_OUTPUT RtttlOutputMixer
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  elif defined(USE_WAVETABLE_OUTPUT)
+#define RTTTL_OUTPUT RtttlOutputWavetable
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  elif defined(ESP32)
+#define RTTTL_OUTPUT RtttlOutputLEDC
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  elif defined(USE_PWM_OUTPUT)
+#define RTTTL_OUTPUT RtttlOutputPWM
+#define RTTTL_OUTPUT_HAS_NO_TONE_DURATION
+#  else
+#define RTTTL_OUTPUT RtttlOutputTone
+#  endif
+#endif
+//#define USE_RTTTL_STATISTICS // Collects counters, a lateness histogram and a ring buffer of the last notes in State.Statistics, without perturbing the timing like TRACE.
 //#define USE_NO_RTX_EXTENSIONS // Disables RTX format definitions `'s'` (style) and `'l'` (loop). Saves up to 332 bytes program memory
 // Even with `USE_NO_RTX_EXTENSIONS` the default style is natural (Tone length = note length - 1/16)
 
 #define DEFAULT_DURATION 4
 #define DEFAULT_OCTAVE 6
 #define DEFAULT_BPM 63
+#define RTTTL_WHOLE_NOTE_MICROS_AT_ONE_BPM (4 * 60 * 1000000UL) // BPM is quarter notes per minute
 
 #define RTX_STYLE_CONTINUOUS 'C'  // Tone length = note length
 #define RTX_STYLE_NATURAL 'N'     // Tone length = note length - 1/16
@@ -91,6 +178,7 @@ void printName(const char *aRTTTLArrayPtr, Print *aSerial);
 
 void startPlayRtttl(uint8_t aTonePin, const char *aRTTTLArrayPtr, void (*aOnComplete)()=nullptr);
 void playRtttlBlocking(uint8_t aTonePin, const char *aRTTTLArrayPtr);
+void playRtttlBlockingLowPower(uint8_t aTonePin, const char *aRTTTLArrayPtr); // Sleeps between the notes instead of calling delay(1)
 
 void startPlayRandomRtttlFromArray(uint8_t aTonePin, const char *const aSongArray[], uint8_t aNumberOfEntriesInSongArray,
         char *aBufferPointer = nullptr, uint8_t aBufferSize = 0, void (*aOnComplete)()=nullptr);
@@ -107,6 +195,45 @@ void printNamePGMPGM(const char *const*aRTTTLPGMArrayPtrPGM, Print *aSerial);
 void startPlayRtttlPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM, void (*aOnComplete)()=nullptr);
 void startPlayRtttlPGMPGM(uint8_t aTonePin, const char *const*aRTTTLPGMArrayPtrPGM, void (*aOnComplete)()=nullptr);
 void playRtttlBlockingPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM);
+void playRtttlBlockingLowPowerPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM);
+
+/*
+ * Address of RTTTL data for the different memory types
+ */
+#if defined(__AVR__) && defined(RAMPZ)
+typedef uint32_t rtttlAddress_t; // To address FLASH above 64k with pgm_read_byte_far()
+#else
+typedef uintptr_t rtttlAddress_t;
+#endif
+
+void startPlayRtttlFarPGM(uint8_t aTonePin, rtttlAddress_t aRTTTLArrayAddressFarPGM, void (*aOnComplete)()=nullptr);
+#if defined(__AVR__)
+void startPlayRtttlEEPROM(uint8_t aTonePin, const char *aRTTTLArrayPtrEEPROM, void (*aOnComplete)()=nullptr);
+#endif
+void startPlayRtttlFromCallback(uint8_t aTonePin, char (*aReadCharFunction)(rtttlAddress_t aAddress), rtttlAddress_t aStartAddress,
+        void (*aOnComplete)()=nullptr);
+
+/*
+ * Streaming version, the song is read character by character from e.g. Serial while playing.
+ * The song must be terminated by '\0', '\n' or '\r'. Loops are not supported.
+ */
+#if !defined(RTTTL_STREAM_BUFFER_SIZE)
+#define RTTTL_STREAM_BUFFER_SIZE    32 // Must be a power of 2, checked by static_assert, and greater than the header length (without name)
+#endif
+#define RTTTL_STREAM_READ_NAME      0
+#define RTTTL_STREAM_READ_HEADER    1
+#define RTTTL_STREAM_READ_NOTES     2
+struct rtttlStreamBuffer {
+    Stream *StreamPtr;
+    rtttlAddress_t WriteAddress; // Address of the next character to be received. Read address is playRtttlState.NextTonePointer.
+    uint16_t NumberOfUnderruns;  // Number of notes, which could not be played at time, because their data was not yet received
+    uint8_t Phase;               // RTTTL_STREAM_READ_NAME etc.
+    bool IsInUnderrun;
+    char Buffer[RTTTL_STREAM_BUFFER_SIZE];
+};
+extern struct rtttlStreamBuffer sRtttlStreamBuffer;
+void startPlayRtttlFromStream(uint8_t aTonePin, Stream *aStream, void (*aOnComplete)()=nullptr);
+uint16_t getPlayRtttlStreamUnderruns();
 
 void startPlayRandomRtttlFromArrayPGM(uint8_t aTonePin, const char *const aSongArrayPGM[], uint8_t aNumberOfEntriesInSongArrayPGM,
         char *aBufferPointer = nullptr, uint8_t aBufferSize = 0, void (*aOnComplete)()=nullptr);
@@ -116,40 +243,438 @@ void startPlayRandomRtttlFromArrayPGMAndPrintName(uint8_t aTonePin, const char *
 void playRandomRtttlSampleBlockingPGM(uint8_t aTonePin);
 void playRandomRtttlSampleBlockingPGMAndPrintName(uint8_t aTonePin, Print *aSerial);
 
+/*
+ * Compiled format. Each note is stored in one 16 bit word, so no text parsing is required while playing.
+ * Layout of a compiled song: <BPM>, <(Loops << 8) | StyleDivisorValue>, <Note>, <Note>, ..., RTTTL_COMPILED_END
+ *
+ * Note word:
+ *  Bit 0 to 3:   Index in Notes[] array 0 to 11 or RTTTL_COMPILED_PAUSE
+ *  Bit 4 to 7:   Octave
+ *  Bit 8 to 10:  Duration exponent, duration number = 1 << exponent, i.e. 0 for a whole, 2 for a quarter note etc.
+ *  Bit 11 to 12: Number of dots, each dot increases duration by half
+ */
+#define RTTTL_COMPILED_NOTE_MASK        0x0F
+#define RTTTL_COMPILED_PAUSE            0x0F
+#define RTTTL_COMPILED_OCTAVE_SHIFT     4
+#define RTTTL_COMPILED_OCTAVE_MASK      0x0F
+#define RTTTL_COMPILED_DURATION_SHIFT   8
+#define RTTTL_COMPILED_DURATION_MASK    0x07
+#define RTTTL_COMPILED_DOTS_SHIFT       11
+#define RTTTL_COMPILED_DOTS_MASK        0x03
+#define RTTTL_COMPILED_END              0xFFFF
+#define RTTTL_COMPILED_HEADER_SIZE      2 // BPM and (Loops << 8) | StyleDivisorValue
+#define RTTTL_COMPILED_STYLE_DEFAULT    0xFF // Use the value of setDefaultStyle() at start of playing
+#define RTTTL_COMPILED_NOTE(aNoteIndex, aOctave, aDurationExponent, aNumberOfDots) \
+    ((uint16_t) ((aNoteIndex) | ((aOctave) << RTTTL_COMPILED_OCTAVE_SHIFT) | ((aDurationExponent) << RTTTL_COMPILED_DURATION_SHIFT) \
+            | ((aNumberOfDots) << RTTTL_COMPILED_DOTS_SHIFT)))
+
+void startPlayRtttlCompiled(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, void (*aOnComplete)()=nullptr);
+void startPlayRtttlCompiledPGM(uint8_t aTonePin, const uint16_t *aCompiledArrayPtrPGM, void (*aOnComplete)()=nullptr);
+uint16_t convertRtttlToCompiled(const char *aRTTTLArrayPtr, uint16_t *aCompiledArrayPtr, uint16_t aCompiledArraySize);
+uint16_t convertRtttlToCompiledPGM(const char *aRTTTLArrayPtrPGM, uint16_t *aCompiledArrayPtr, uint16_t aCompiledArraySize);
+
+/*
+ * Packed song bank in FLASH, generated from RTTTL texts by extras/host/RtttlPack, see PlayRtttlPackedMelodies.h.
+ * The notes are stored as 4 bit tokens (nibbles), octave and duration only if they change.
+ * Sequences of nibbles, which are repeated in the songs of the bank, are stored once as phrase and referenced by 3 nibbles.
+ * While playing, the phrases are inserted transparently, so the decoder state is only the nibble index of the song
+ * and the end and return index of the current phrase.
+ *
+ * Layout of a bank: <NumberOfSongs>, <NumberOfPhrases>, <Start of song>..., <Start of phrase>..., <End of last phrase>, <Nibbles>
+ * Start and end are 16 bit little endian nibble indices relative to the start of the bank, so a bank is limited to 32 kByte.
+ * The high nibble of a byte is the first one.
+ * Song: <BPM 3 nibbles>, <Loops 1 nibble>, <StyleDivisorValue 2 nibbles>, <Token>, ..., RTTTL_PACKED_ESCAPE, 0xF, 0xF
+ * Token:
+ *  0 to 11:                Note c to b with current octave and duration
+ *  RTTTL_PACKED_PAUSE:     Pause with current duration
+ *  RTTTL_PACKED_DURATION:  Next nibble is the new current duration, duration exponent as in compiled format | RTTTL_PACKED_DOT
+ *  RTTTL_PACKED_OCTAVE:    Next nibble is the new current octave
+ *  RTTTL_PACKED_ESCAPE:    Next 2 nibbles are the index of the phrase to insert or RTTTL_PACKED_END
+ */
+#define RTTTL_PACKED_PAUSE          12
+#define RTTTL_PACKED_DURATION       13
+#define RTTTL_PACKED_OCTAVE         14
+#define RTTTL_PACKED_ESCAPE         15
+#define RTTTL_PACKED_DOT            0x08
+#define RTTTL_PACKED_END            0xFF // Phrase index for end of song, so a bank can have up to 255 phrases
+#define RTTTL_PACKED_SONG_HEADER_NIBBLES    6
+struct rtttlPackedDecoder {
+    const uint8_t *BankPGM;
+    uint16_t PhraseEnd;     // Nibble index of the end of the current phrase, 0 if not in a phrase
+    uint16_t PhraseReturn;  // Nibble index in the song after the reference of the current phrase
+};
+void startPlayRtttlPackedPGM(uint8_t aTonePin, const uint8_t *aPackedBankPGM, uint8_t aSongIndex, void (*aOnComplete)()=nullptr);
+uint8_t getRtttlPackedNumberOfSongsPGM(const uint8_t *aPackedBankPGM);
+
+/*
+ * Information about a song, computed by getRtttlInfo() without playing it
+ */
+struct rtttlInfo {
+    uint32_t DurationMillis;    // Duration of all loops including style gaps. If NumberOfLoops is 0 (forever), duration of one loop.
+    uint16_t NumberOfNotes;     // Notes and pauses of one loop
+    uint16_t MinimumFrequency;  // Lowest frequency played, 0 if the song contains only pauses
+    uint16_t MaximumFrequency;
+    // The values of the header or their defaults
+    uint8_t DefaultDuration;    // d=
+    uint8_t DefaultOctave;      // o=
+    uint16_t BeatsPerMinute;    // b=
+    uint8_t StyleDivisorValue;  // s= converted to the divisor, see RTTTL_STYLE_*
+    uint8_t NumberOfLoops;      // l=, 0 means forever
+};
+void getRtttlInfo(const char *aRTTTLArrayPtr, struct rtttlInfo *aInfo);
+void getRtttlInfoPGM(const char *aRTTTLArrayPtrPGM, struct rtttlInfo *aInfo);
+
+/*
+ * Sparse index of the start times of notes of one loop, for fast seeking with seekPlayRtttl().
+ * Built in one pass by buildRtttlSeekIndex(). If the song has more notes than checkpoints,
+ * only every 2nd, 4th etc. note gets a checkpoint, so seeking requires a binary search and a scan of a few notes.
+ */
+#if !defined(RTTTL_SEEK_INDEX_SIZE)
+#define RTTTL_SEEK_INDEX_SIZE   16 // Must be a power of 2
+#endif
+struct rtttlSeekCheckpoint {
+    uint32_t Micros;            // Start time of the note relative to the start of the loop
+    rtttlAddress_t Address;     // Address of the note
+};
+#define RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS    (0xFFFFFFFF / 1000) // 71.5 minutes, the offset is converted to microseconds
+/*
+ * The index must only be used for the song it was built for. Without USE_NO_RTX_EXTENSIONS, seekPlayRtttl() returns false
+ * for the index of another song. With USE_NO_RTX_EXTENSIONS this cannot be checked and a wrong index seeks into the other song.
+ */
+struct rtttlSeekIndex {
+    uint32_t DurationOfLoopMicros;
+    uint8_t NumberOfCheckpoints;
+    struct rtttlSeekCheckpoint Checkpoints[RTTTL_SEEK_INDEX_SIZE]; // Checkpoints[0] is the first note
+};
+void buildRtttlSeekIndex(const char *aRTTTLArrayPtr, struct rtttlSeekIndex *aSeekIndex);
+void buildRtttlSeekIndexPGM(const char *aRTTTLArrayPtrPGM, struct rtttlSeekIndex *aSeekIndex);
+// To be called after a start function. Returns false if song is stopped, because aOffsetMillis is behind its end,
+// or if aOffsetMillis > RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS.
+bool seekPlayRtttl(uint32_t aOffsetMillis, const struct rtttlSeekIndex *aSeekIndex = nullptr);
+
 // To be called from loop. - Returns true if tone is playing, false if tone has ended or stopped
 bool updatePlayRtttl();
+// To be called from a periodic timer interrupt e.g. every millisecond, if enabled by setPlayRtttlUpdateFromInterrupt(true)
+void updatePlayRtttlFromInterrupt();
+void setPlayRtttlUpdateFromInterrupt(bool aUpdateFromInterrupt);
+// For low power, call them instead of polling updatePlayRtttl() continuously
+uint32_t getPlayRtttlMicrosToNextAction(); // 0 if the next action is due or song is not running
+// Enables interrupts if update from interrupt is enabled, except on AVR. So do not call it with interrupts disabled on other platforms.
+void sleepUntilPlayRtttlNextAction(); // AVR idle sleep or delay() until the next action is due
+#if defined(USE_RTTTL_STATISTICS)
+void printPlayRtttlStatistics(Print *aSerial); // Prints counters, lateness histogram and the last notes
+void resetPlayRtttlStatistics();
+#endif
+/*
+ * Handling of notes, which are due for longer than RTTTL_LATE_NOTE_MICROS, e.g. because loop() was blocked
+ */
+#if !defined(RTTTL_LATE_NOTE_MICROS)
+#define RTTTL_LATE_NOTE_MICROS      5000 // Notes started later than this are late
+#endif
+#define RTTTL_LATE_POLICY_SHIFT     0 // Default, like in version 2.2.0. The late note is played with full length and the rest of the song is shifted.
+#define RTTTL_LATE_POLICY_SHORTEN   1 // The tone of the late note ends at its scheduled time, so the song stays on its timeline.
+#define RTTTL_LATE_POLICY_DROP      2 // Notes, whose whole duration has passed, are not played. The next note is shortened.
+void setPlayRtttlLatePolicy(uint8_t aLatePolicy);
+uint16_t getPlayRtttlNumberOfShortenedNotes(); // since start of song
+uint16_t getPlayRtttlNumberOfDroppedNotes();
 bool isPlayRtttlRunning();
+void prepareNextRtttlNote(struct playRtttlState *aState); // internal, decodes the next note while the current note is playing
 
 void stopPlayRtttl();
 
+struct rtttlNote;
+
+// Return values of ParseNextNote()
+#define RTTTL_PARSE_OK              0
+#define RTTTL_PARSE_END_OF_SONG     1
+#define RTTTL_PARSE_NO_DATA         2 // Data for next note is not yet available, try again later
+
+/*
+ * The next note, decoded in advance directly after the current note was started.
+ * Thus at the start of a note only the output of the already computed tone is required.
+ */
+struct rtttlPreparedNote {
+    uint8_t ParseResult;            // RTTTL_PARSE_OK, RTTTL_PARSE_END_OF_SONG or RTTTL_PARSE_NO_DATA
+    uint16_t Frequency;             // 0 for pause
+    unsigned long Duration;         // Duration of the note in microseconds
+    unsigned long DurationOfTone;   // Duration of the tone output in milliseconds, i.e. note duration minus the style gap
+#if defined(USE_DIRECT_TIMER2_OUTPUT)
+    uint16_t Timer2Entry;           // (<prescaler bits> << 8) | <compare value> from RtttlTimer2Table
+#endif
+#if defined(USE_SOFTWARE_TONE_OUTPUT)
+    uint32_t SoftwareToneHalfPeriod; // Half period in 1/256 interrupt ticks, see RtttlOutputSoftwareTone
+#endif
+#if defined(USE_MIXER_OUTPUT) || defined(USE_WAVETABLE_OUTPUT)
+    uint16_t PhaseIncrement;        // Added to the 16 bit phase of the voice at each sample, see getRtttlPhaseIncrement()
+#endif
+#if defined(USE_WAVETABLE_OUTPUT)
+    uint8_t WavetableReleaseStep;   // Attenuation added at each envelope step after the tone, so the release ends within the style gap
+#endif
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    uint32_t DurationOfToneMicros;  // DurationOfTone * 1000, to call silence() at end of tone
+#endif
+};
+
+/*
+ * Durations for the common note lengths 1, 2, 4, 8, 16, 32 without and with one dot.
+ * Computed once at start of song, so playing these notes requires no division.
+ */
+#if !defined(USE_NO_DURATION_TABLE)
+#define RTTTL_DURATION_TABLE_EXPONENTS  6 // 1/1 to 1/32
+#define RTTTL_DURATION_TABLE_DOTS       2 // 0 and 1 dot
+struct rtttlDurationTableEntry {
+    unsigned long Duration;         // Duration of the note in microseconds
+    unsigned long DurationOfTone;   // Duration of the tone output in milliseconds
+};
+#endif
+
+#if defined(USE_RTTTL_STATISTICS)
+#  if !defined(RTTTL_STATISTICS_NUMBER_OF_RECORDS)
+#define RTTTL_STATISTICS_NUMBER_OF_RECORDS  8 // Must be a power of 2 up to 256, checked by static_assert. Each record requires 14 bytes RAM on AVR.
+#  endif
+#define RTTTL_LATENESS_HISTOGRAM_BINS               10
+#define RTTTL_LATENESS_HISTOGRAM_FIRST_BIN_MICROS   64 // Bin n counts the lateness below (64 << n) us, the last bin counts the rest
+/*
+ * Binary record of a played note, stored in a ring buffer while playing and printed later
+ */
+struct rtttlNoteRecord {
+    uint32_t ScheduledMicros;       // Deadline of the note
+    uint32_t ActualMicros;          // micros() at start of the note
+    uint32_t Duration;              // Duration of the note in microseconds
+    uint16_t Frequency;             // 0 for pause
+};
+
+struct rtttlStatistics {
+    uint32_t NumberOfNotes;         // Notes and pauses played
+    uint32_t NumberOfUpdates;       // Calls of update() or updateFromInterrupt() while playing
+    uint16_t NumberOfLoopRestarts;  // Restarts of the song by the RTX loop extension
+    uint16_t NumberOfLateNotes;     // Notes started later than RTTTL_LATE_NOTE_MICROS
+    uint32_t MaximumLatenessMicros;
+    uint32_t SumOfLatenessMicros;   // Mean lateness is SumOfLatenessMicros / NumberOfNotes
+    uint16_t LatenessHistogram[RTTTL_LATENESS_HISTOGRAM_BINS];
+    uint8_t IndexOfNextRecord;
+    struct rtttlNoteRecord Records[RTTTL_STATISTICS_NUMBER_OF_RECORDS]; // The last played notes
+};
+#endif
+
 struct playRtttlState {
-    long MillisOfNextAction;
-    const char *NextTonePointer;
+    uint32_t MicrosOfNextAction; // Deadline for the next note. Advanced by the note duration and not set from micros() to avoid drift.
+    rtttlAddress_t NextTonePointer;
+    // Parser for the memory type of the song, set at start. Returns RTTTL_PARSE_OK, RTTTL_PARSE_END_OF_SONG or RTTTL_PARSE_NO_DATA.
+    uint8_t (*ParseNextNote)(struct playRtttlState *aState, struct rtttlNote *aNote);
+    union {
+        // Used by startPlayRtttlFromCallback()
+        char (*ReadCharFunction)(rtttlAddress_t aAddress);
+        // Used by startPlayRtttlFromStream()
+        struct rtttlStreamBuffer *StreamBuffer;
+        // Used by startPlayRtttlPackedPGM()
+        struct rtttlPackedDecoder Packed;
+    };
+
+    /*
+     * Not part of Flags, since it is written by updateFromInterrupt() and the bit field of Flags is written by the main program.
+     * Setting it to false at start of a start function locks out updateFromInterrupt() until the state is completely set up.
+     */
+    volatile bool IsRunning; // is false after boot and after construction of an RtttlPlayer
+    volatile bool IsCompletionPending; // Set by updateFromInterrupt() at end of song, OnComplete is then called by update()
 
     struct {
-        uint8_t IsRunning :1; // is false after boot
         uint8_t IsPGMMemory :1;
         uint8_t IsTonePinInverted :1; // True if tone pin has inverted logic i.e. is active on low.
+        uint8_t IsCompiled :1; // True if NextTonePointer points to compiled 16 bit notes and not to RTTTL text
+        uint8_t IsUpdatedFromInterrupt :1; // True if notes are played by updateFromInterrupt() and update() is only a status query
+        uint8_t LatePolicy :2; // RTTTL_LATE_POLICY_SHIFT etc.
     } Flags;
+    uint16_t NumberOfShortenedNotes; // Late notes with shortened tone since start of song
+    uint16_t NumberOfDroppedNotes; // Late notes not played since start of song
 
     // Tone pin to use for output
     uint8_t TonePin;
+#if defined(USE_DIRECT_TIMER2_OUTPUT)
+    uint8_t Timer2CompareOutputMode; // _BV(COM2A0) or _BV(COM2B0) for toggling the OC2A or OC2B pin, 0 if tone() must be used for TonePin
+#endif
+#if defined(USE_MIXER_OUTPUT)
+    uint8_t MixerVoiceIndex; // Voice of RtttlOutputMixer used by this player or RTTTL_MIXER_NO_VOICE
+#endif
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    volatile bool IsToneOn;          // Not part of Flags, since it can be written by updateFromInterrupt()
+    uint32_t MicrosOfToneEnd;        // silence() is called at this time, to generate the gap between the notes
+#endif
     // Callback on completion of tone
     void (*OnComplete)(void);
 
-    uint8_t DefaultDuration;
-    uint8_t DefaultOctave;
-    long TimeForWholeNoteMillis;
+    uint8_t DefaultDuration; // For packed songs the current duration nibble
+    uint8_t DefaultOctave;   // For packed songs the current octave
+    uint16_t BeatsPerMinute;
+    unsigned long TimeForWholeNoteMicros;
+#if !defined(USE_NO_DURATION_TABLE)
+    struct rtttlDurationTableEntry DurationTable[RTTTL_DURATION_TABLE_EXPONENTS][RTTTL_DURATION_TABLE_DOTS];
+#endif
+    struct rtttlPreparedNote NextNote;
+#if defined(USE_RTTTL_STATISTICS)
+    struct rtttlStatistics Statistics; // Accumulated over all songs until resetStatistics() is called
+#endif
 #if !defined(USE_NO_RTX_EXTENSIONS)
     uint8_t NumberOfLoops;  // 0 means forever, 1 means we are in the last loop
     // The divisor for the formula: Tone length = note length - note length * (1 / divisor)
     // If 0 then Tone length = note length;
     uint8_t StyleDivisorValue;
-    const char *LastTonePointer; // used for loops
+    rtttlAddress_t LastTonePointer; // used for loops
+
+#endif
+};
+
+/*
+ * Compact copy of the playing position of a song, to interrupt it by another song and resume it later.
+ * The durations of the notes are computed again from BeatsPerMinute at restore, so the duration table is not copied.
+ */
+struct rtttlSnapshot {
+    uint32_t RemainingMicros;               // Time until NextNote is due, the rest of the interrupted note is resumed as pause
+    rtttlAddress_t NextTonePointer;
+    uint8_t (*ParseNextNote)(struct playRtttlState *aState, struct rtttlNote *aNote);
+    struct rtttlPackedDecoder Source;       // Copy of the union of ReadCharFunction, StreamBuffer and Packed, Packed is the biggest member
+    void (*OnComplete)(void);
+    struct rtttlPreparedNote NextNote;
+    uint16_t BeatsPerMinute;
+    uint8_t DefaultDuration;
+    uint8_t DefaultOctave;
+    uint8_t TonePin;
+    bool IsRunning;
+    bool IsPGMMemory;
+    bool IsCompiled;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    uint8_t NumberOfLoops;
+    uint8_t StyleDivisorValue;
+    rtttlAddress_t LastTonePointer;
+#endif
+};
+
+/*
+ * Fixed depth stack of snapshots for pushPlayRtttl() and popPlayRtttl() of sDefaultRtttlPlayer
+ */
+#if !defined(RTTTL_SNAPSHOT_STACK_SIZE)
+#define RTTTL_SNAPSHOT_STACK_SIZE   2 // Each snapshot requires about 40 bytes RAM on AVR
+#endif
+struct rtttlSnapshotStack {
+    uint8_t NumberOfSnapshots;
+    struct rtttlSnapshot Snapshots[RTTTL_SNAPSHOT_STACK_SIZE];
+};
+extern struct rtttlSnapshotStack sRtttlSnapshotStack;
+// Interrupt the current song by another one, the current song is resumed at end of the other one. Returns false if stack is full.
+bool pushPlayRtttl(uint8_t aTonePin, const char *aRTTTLArrayPtr);
+bool pushPlayRtttlPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM);
+// Resume the song interrupted by the last push. Called automatically at end of the pushed song. Returns false if stack is empty.
+bool popPlayRtttl();
 
+/*
+ * Live pitch for instruments, e.g. controlled by a sensor. Do not use it while a song is played on the same timer.
+ * On the OC2A and OC2B pins (11 and 3 on Uno / Nano), the pitch is changed without restarting Timer2, so there are no clicks.
+ * Other pins use tone(), which is only called if the frequency changes.
+ * After stopLivePitch(), the pin is HIGH if setTonePinIsInverted(true) was called, otherwise LOW.
+ */
+struct rtttlLivePitch {
+    uint8_t TonePin;
+    uint16_t Frequency;             // 0 if no tone is playing
+#if defined(TCCR2A)
+    uint8_t Timer2CompareOutputMode; // _BV(COM2A0) or _BV(COM2B0) for toggling the OC2A or OC2B pin, 0 if tone() is used
+    uint16_t Timer2Entry;           // (<prescaler bits> << 8) | <compare value> of the current tone
 #endif
 };
-extern struct playRtttlState sPlayRtttlState;
+extern struct rtttlLivePitch sRtttlLivePitch;
+void setLivePitch(uint8_t aTonePin, uint16_t aFrequency); // 0 stops the tone
+#define RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE (NOTES_OCTAVE + 4) // The highest octave, for which the frequency of b fits into 16 bit
+void setLiveNote(uint8_t aTonePin, uint8_t aNoteIndex, uint8_t aOctave); // aNoteIndex is the index 0 to 11 in Notes[], 0 is c
+void stopLivePitch();
+
+/*
+ * Waveforms of USE_WAVETABLE_OUTPUT, the pulse waves have no DC component
+ */
+#define RTTTL_WAVEFORM_SINE             0
+#define RTTTL_WAVEFORM_TRIANGLE         1
+#define RTTTL_WAVEFORM_PULSE_50         2 // square wave
+#define RTTTL_WAVEFORM_PULSE_25         3
+#define RTTTL_WAVEFORM_PULSE_12         4 // 12.5 % duty cycle
+#define RTTTL_NUMBER_OF_WAVEFORMS       5
+#if defined(USE_WAVETABLE_OUTPUT)
+void setRtttlWaveform(uint8_t aWaveform); // Used from the next note on
+#endif
+
+/*
+ * A player with its own state, to play different songs at the same time, e.g. on 2 pins.
+ * The functions startPlayRtttl*(), updatePlayRtttl() etc. use the instance sDefaultRtttlPlayer.
+ * The Arduino AVR core tone() can only generate one tone at a time, so for a second concurrent player,
+ * you need a core, which supports tone() on multiple pins, e.g. ESP32.
+ */
+class RtttlPlayer {
+public:
+    /*
+     * Zeroes the state, so that a local or heap allocated player is not running before its first start.
+     * Being constexpr, sDefaultRtttlPlayer is still initialized at compile time and can be used by other global constructors.
+     */
+    constexpr RtttlPlayer() :
+            State() {
+    }
+    void start(uint8_t aTonePin, const char *aRTTTLArrayPtr, void (*aOnComplete)()=nullptr);
+    void startPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM, void (*aOnComplete)()=nullptr);
+    void startFarPGM(uint8_t aTonePin, rtttlAddress_t aRTTTLArrayAddressFarPGM, void (*aOnComplete)()=nullptr);
+#if defined(__AVR__)
+    void startEEPROM(uint8_t aTonePin, const char *aRTTTLArrayPtrEEPROM, void (*aOnComplete)()=nullptr);
+#endif
+    void startFromCallback(uint8_t aTonePin, char (*aReadCharFunction)(rtttlAddress_t aAddress), rtttlAddress_t aStartAddress,
+            void (*aOnComplete)()=nullptr);
+    void startFromStream(uint8_t aTonePin, Stream *aStream, struct rtttlStreamBuffer *aStreamBuffer, void (*aOnComplete)()=nullptr);
+    uint16_t getStreamUnderruns();
+    void startCompiled(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, void (*aOnComplete)()=nullptr);
+    void startCompiledPGM(uint8_t aTonePin, const uint16_t *aCompiledArrayPtrPGM, void (*aOnComplete)()=nullptr);
+    void startPackedPGM(uint8_t aTonePin, const uint8_t *aPackedBankPGM, uint8_t aSongIndex, void (*aOnComplete)()=nullptr);
+
+    // To be called from loop. - Returns true if tone is playing, false if tone has ended or stopped
+    bool update();
+    // To be called from a periodic timer interrupt, if enabled by setUpdateFromInterrupt(true)
+    void updateFromInterrupt();
+    void setUpdateFromInterrupt(bool aUpdateFromInterrupt);
+    uint32_t getMicrosToNextAction();
+    void sleepUntilNextAction();
+    bool seek(uint32_t aOffsetMillis, const struct rtttlSeekIndex *aSeekIndex = nullptr);
+    void saveSnapshot(struct rtttlSnapshot *aSnapshot);
+    void restoreSnapshot(const struct rtttlSnapshot *aSnapshot);
+    bool isRunning();
+    void stop();
+#if defined(USE_RTTTL_STATISTICS)
+    void printStatistics(Print *aSerial);
+    void resetStatistics();
+#endif
+
+    void setTonePinIsInverted(bool aTonePinIsInverted);
+    void setLatePolicy(uint8_t aLatePolicy);
+    uint16_t getNumberOfShortenedNotes();
+    uint16_t getNumberOfDroppedNotes();
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    void setNumberOfLoops(uint8_t aNumberOfLoops);
+#endif
+
+    struct playRtttlState State;
+
+private:
+    template<typename Source> void startFromSource(uint8_t aTonePin, rtttlAddress_t aAddress, bool aIsPGMMemory,
+            void (*aOnComplete)());
+    void startCompiledInternal(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, bool aIsPGMMemory, void (*aOnComplete)());
+    void startAtFirstNote(rtttlAddress_t aFirstNoteAddress);
+    bool playNoteIfDue();
+    bool seekFromNote(uint32_t aOffsetMicros, uint32_t aStartMicros);
+};
+extern RtttlPlayer sDefaultRtttlPlayer;
+extern struct playRtttlState &sPlayRtttlState; // The state of sDefaultRtttlPlayer
+
+/*
+ * One note as parsed from RTTTL text
+ */
+struct rtttlNote {
+    uint8_t Note;           // 0 to 11 for c to b, 12 for b#, values > 12 are pause
+    uint8_t Octave;
+    uint8_t DurationNumber; // 1 for a whole, 4 for a quarter note etc.
+    uint8_t NumberOfDots;   // Each dot increases duration by half
+};
 
 #if !defined(USE_NO_RTX_EXTENSIONS)
 extern uint8_t sDefaultStyleDivisorValue;
@@ -291,6 +816,34 @@ static const char *const RTTTLChristmasMelodies[] PROGMEM = { JingleBell, Rudolp
 #endif
 
 /*
+ * Version 2.3.0 - work in progress
+ * - Compiled format with one 16 bit word per note and functions startPlayRtttlCompiled(), startPlayRtttlCompiledPGM() and convertRtttlToCompiled().
+ * - Build time compilation of RTTTL strings with RTTTL_COMPILE() for C++17.
+ * - One templated parser for all memory types and new functions startPlayRtttlFarPGM(), startPlayRtttlEEPROM() and startPlayRtttlFromCallback().
+ * - Streaming playback with startPlayRtttlFromStream().
+ * - The next note is decoded while the current note is playing, so a note starts without parsing delay.
+ * - Linux host build with mock Arduino HAL and benchmark in extras/host.
+ * - Drift free timing with absolute deadlines in microseconds, which is also correct at micros() rollover.
+ * - No division at playing a note, by using a table of durations computed at start of song. Can be disabled by USE_NO_DURATION_TABLE.
+ * - Class RtttlPlayer for playing multiple songs at the same time.
+ * - Notes can be played by a timer interrupt with updatePlayRtttlFromInterrupt(), to be independent of loop latency.
+ * - USE_DIRECT_TIMER2_OUTPUT starts notes with a compile time table of Timer2 register values instead of tone().
+ * - Output backends selected at compile time by RTTTL_OUTPUT, for tone(), ESP32 LEDC, direct Timer2, PWM or your own output.
+ * - Low power playing with getPlayRtttlMicrosToNextAction(), sleepUntilPlayRtttlNextAction() and playRtttlBlockingLowPower().
+ * - USE_RTTTL_STATISTICS for counters, lateness histogram and a ring buffer of the last notes, printed by printPlayRtttlStatistics().
+ * - Host renderer for WAV files of the songs in extras/host.
+ * - Golden trace of all songs in extras/host, checked with make check-trace for RAM, PGM, compiled format and micros() rollover.
+ * - Functions getRtttlInfo() and getRtttlInfoPGM() for duration, number of notes, frequency range and header values of a song without playing it.
+ * - Start playing at any time in the song with seekPlayRtttl(), optionally using an index built by buildRtttlSeekIndex().
+ * - Packed song bank with shared phrase dictionary for startPlayRtttlPackedPGM(), generated by extras/host/RtttlPack.
+ * - Interrupt a song by an alert with pushPlayRtttl() and resume it at its position with popPlayRtttl().
+ * - Policy for late notes with setPlayRtttlLatePolicy() to shift, shorten or drop them, and counters of shortened and dropped notes.
+ *   The default shift plays late notes with full length like before.
+ * - Live pitch with setLivePitch() and setLiveNote(), which change the pitch on the Timer2 pins without restarting the timer.
+ * - USE_SOFTWARE_TONE_OUTPUT generates the tone on any pin by a fixed rate Timer1 interrupt with precomputed half periods.
+ * - USE_MIXER_OUTPUT mixes the songs of 2 to 4 players to one PWM pin of Timer1.
+ * - USE_WAVETABLE_OUTPUT plays sine, triangle or pulse wavetables with attack, decay and release envelope on one PWM pin of Timer1.
+ *
  * Version 2.2.0 02/2026
  * - Converted to use ESP32 version 3.x.
  * - Added switch to direct hardware toggle output at OC2B / pin 3
@@ -34,7 +34,7 @@
 
 #include "PlayRtttl.h"
 
-//#define TRACE // Activate it to see the note played on Serial output
+//#define TRACE // Activate it to see the note played on Serial output. Printing changes the timing, USE_RTTTL_STATISTICS does not.
 #if defined(TRACE)
 // Propagate trace level
 #  if !defined(DEBUG)
@@ -52,7 +52,8 @@
 Print *const sPointerToSerial = &Serial;  // requires 0 bytes Flash because it is constant
 #endif //DEBUG
 
-struct playRtttlState sPlayRtttlState;
+RtttlPlayer sDefaultRtttlPlayer; // The instance used by the startPlayRtttl*() and updatePlayRtttl() functions
+struct playRtttlState &sPlayRtttlState = sDefaultRtttlPlayer.State;
 
 /*
  * The frequencies of notes of the highest octave.
@@ -61,721 +62,2685 @@ struct playRtttlState sPlayRtttlState;
 const int Notes[] PROGMEM = { NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7, NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7,
 NOTE_AS7, NOTE_B7 };
 
+#if __cplusplus >= 201703L
+// Build time compiler for RTTTL strings, see RTTTL_COMPILE()
+#include "PlayRtttlCompiler.h"
+static_assert(sizeof(Notes) / sizeof(Notes[0]) == RtttlCompiler::NUMBER_OF_NOTES, "Notes[] and RtttlCompiler::NUMBER_OF_NOTES do not match");
+#endif
+
+/*
+ * Output backends, selected by RTTTL_OUTPUT in PlayRtttl.h.
+ * begin() is called at start of song, start() for each tone and silence() for pauses and at end of song.
+ * All backends must handle an inverted tone pin and must be callable from an interrupt for updatePlayRtttlFromInterrupt().
+ */
+/*
+ * Arduino tone() function, which stops the tone after the duration of the tone
+ */
+struct RtttlOutputTone {
+    static void begin(struct playRtttlState *aState) {
+        (void) aState;
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        tone(aState->TonePin, aNote->Frequency, aNote->DurationOfTone);
+#if defined(TCCR2A)
+        if (aState->TonePin == 11) {
+            // switch to direct hardware toggle output at OC2A / pin 11
+            TCCR2A |= _BV(COM2A0);
+        }
+        if (aState->TonePin == 3) {
+            // switch to direct hardware toggle output at OC2B / pin 3. This indeed works :-), despite of the tone() ISR TIMER2_COMPA_vect.
+            TCCR2A |= _BV(COM2B0);
+        }
+#endif
+    }
+    static void silence(struct playRtttlState *aState) {
+        noTone(aState->TonePin);
+#if defined(TCCR2A)
+        // reset direct hardware toggle output at OC2A / pin 11 and OC2B / pin 3
+        TCCR2A &= ~(_BV(COM2A0) | _BV(COM2B0));
+#endif
+        // noTone sets pin to LOW ->  need to handle inverted pin mode here
+        if (aState->Flags.IsTonePinInverted) {
+            digitalWrite(aState->TonePin, HIGH);
+        }
+    }
+};
+
+#if defined(ESP32)
+/*
+ * ESP32 LEDC with the pin based API of core version 3.x
+ */
+struct RtttlOutputLEDC {
+    static void begin(struct playRtttlState *aState) {
+        (void) aState;
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        ledcWriteTone(aState->TonePin, aNote->Frequency);
+    }
+    static void silence(struct playRtttlState *aState) {
+        ledcWriteTone(aState->TonePin, 0);
+        // ledcWriteTone(pin, 0) leaves the pin LOW -> need to handle inverted pin mode here
+        if (aState->Flags.IsTonePinInverted) {
+            digitalWrite(aState->TonePin, HIGH);
+        }
+    }
+};
+#endif
+
+#if defined(USE_DIRECT_TIMER2_OUTPUT)
+// Compile time table of Timer2 register values for all notes
+#include "PlayRtttlTimerTable.h"
+
+/*
+ * Timer2 in CTC mode toggles the OC2A or OC2B pin, without any interrupt. Other pins use tone().
+ */
+struct RtttlOutputTimer2 {
+    static void begin(struct playRtttlState *aState) {
+        uint8_t tTimer = digitalPinToTimer(aState->TonePin);
+        aState->Timer2CompareOutputMode = (tTimer == TIMER2A) ? _BV(COM2A0) : ((tTimer == TIMER2B) ? _BV(COM2B0) : 0);
+        if (aState->Timer2CompareOutputMode != 0) {
+            silence(aState);
+            pinMode(aState->TonePin, OUTPUT);
+            digitalWrite(aState->TonePin, aState->Flags.IsTonePinInverted ? HIGH : LOW); // level between the tones
+        }
+    }
+    /*
+     * Start the tone only by register writes, the values were computed at compile time.
+     */
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        if (aState->Timer2CompareOutputMode == 0) {
+            RtttlOutputTone::start(aState, aNote);
+            return;
+        }
+        uint16_t tTimer2Entry = aNote->Timer2Entry;
+        TIMSK2 = 0; // disable the interrupt of a previous tone()
+        TCCR2B = 0; // stop timer while changing values
+        TCCR2A = _BV(WGM21) | aState->Timer2CompareOutputMode; // CTC mode with TOP = OCR2A, toggle OC2A or OC2B at compare match
+        OCR2A = tTimer2Entry & RTTTL_TIMER2_COMPARE_MASK;
+        OCR2B = 0; // OC2B toggles at counter value 0, so it has the same frequency as OC2A
+        TCNT2 = 0;
+        TCCR2B = tTimer2Entry >> RTTTL_TIMER2_PRESCALER_SHIFT; // start timer
+    }
+    /*
+     * Stops the timer and disconnects the OC2A and OC2B pins, so they have the level set by digitalWrite() at start of song.
+     */
+    static void silence(struct playRtttlState *aState) {
+        if (aState->Timer2CompareOutputMode == 0) {
+            RtttlOutputTone::silence(aState);
+            return;
+        }
+        TCCR2B = 0;
+        TCCR2A = 0;
+    }
+};
+#endif
+
+#if defined(USE_SOFTWARE_TONE_OUTPUT)
+/*
+ * Half period of the notes of octave NOTES_OCTAVE in 1/4096 interrupt ticks, rounded to nearest, computed at compile time.
+ * The 4 additional fraction bits keep the rounding error of the shifted lower octaves below 0.1 cent.
+ */
+#define RTTTL_SOFTWARE_TONE_HALF_PERIOD(aNoteFrequency) \
+    ((uint16_t) ((F_CPU * 4096ULL + RTTTL_SOFTWARE_TONE_TICK_CYCLES * (unsigned long long) (aNoteFrequency)) \
+            / (2ULL * RTTTL_SOFTWARE_TONE_TICK_CYCLES * (aNoteFrequency))))
+const uint16_t RtttlSoftwareToneTable[] PROGMEM = { RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_C7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_CS7),
+        RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_D7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_DS7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_E7),
+        RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_F7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_FS7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_G7),
+        RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_GS7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_A7), RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_AS7),
+        RTTTL_SOFTWARE_TONE_HALF_PERIOD(NOTE_B7) };
+static_assert(F_CPU * 4096ULL / (2ULL * RTTTL_SOFTWARE_TONE_TICK_CYCLES * NOTE_C7) <= 0xFFFF,
+        "RTTTL_SOFTWARE_TONE_TICK_CYCLES is too small for the 16 bit RtttlSoftwareToneTable");
+
+/*
+ * Returns the half period for RtttlOutputSoftwareTone in 1/256 interrupt ticks, i.e. the whole ticks are in bit 8 to 23.
+ * The shortest half period is one tick, so the highest frequency is half of the interrupt rate.
+ */
+uint32_t getRtttlSoftwareToneHalfPeriod(uint8_t aNoteIndex, uint8_t aOctave) {
+    uint32_t tHalfPeriod = pgm_read_word(&RtttlSoftwareToneTable[aNoteIndex]);
+    if (aOctave <= NOTES_OCTAVE) {
+        tHalfPeriod <<= (NOTES_OCTAVE - aOctave);
+    } else {
+        tHalfPeriod >>= (aOctave - NOTES_OCTAVE);
+    }
+    tHalfPeriod = (tHalfPeriod + 8) >> 4;
+    if (tHalfPeriod < 0x100) {
+        tHalfPeriod = 0x100;
+    }
+    return tHalfPeriod;
+}
+
+/*
+ * The state of the interrupt service routine, written by the main program only with interrupts disabled
+ */
+struct rtttlSoftwareTone {
+    volatile uint8_t *PinInputRegister; // Writing the mask to the PINx register toggles the pin
+    uint8_t PinMask;
+    uint16_t TicksToToggle;
+    uint16_t HalfPeriodTicks;
+    uint8_t HalfPeriodFraction; // in 1/256 ticks, added to FractionSum at each toggle
+    uint8_t FractionSum;
+} sRtttlSoftwareTone;
+
+/*
+ * Called by the fixed rate interrupt. Counts down the whole ticks of the half period and toggles the pin by a direct port write.
+ * The fraction of the half period is accumulated, and its carry adds one tick, so the mean frequency is exact
+ * and each edge is at most one tick off its exact time.
+ *
+ * Estimated cycle budget for an AVR, counted for the expected avr-gcc code, not measured:
+ * 7 cycles for interrupt response and vector jump, 22 for the prologue with 7 saved registers, 12 for counting down and 25 for the epilogue with reti,
+ * i.e. 66 cycles per tick and about 23 additional cycles at each toggle.
+ * At the default 20 kHz this is 8 to 11 % CPU for 16 MHz and 17 to 22 % for 8 MHz, and for 5 kHz at 1 MHz 33 to 44 %, the higher values for the highest notes.
+ * The millis() interrupt delays the edges by its run time, but no tick is lost as long as it is shorter than one tick.
+ */
+static inline void handleRtttlSoftwareToneTick() {
+    uint16_t tTicks = sRtttlSoftwareTone.TicksToToggle - 1;
+    if (tTicks == 0) {
+        *sRtttlSoftwareTone.PinInputRegister = sRtttlSoftwareTone.PinMask;
+        uint8_t tFractionSum = sRtttlSoftwareTone.FractionSum + sRtttlSoftwareTone.HalfPeriodFraction;
+        tTicks = sRtttlSoftwareTone.HalfPeriodTicks;
+        if (tFractionSum < sRtttlSoftwareTone.FractionSum) {
+            tTicks++; // carry of the fraction
+        }
+        sRtttlSoftwareTone.FractionSum = tFractionSum;
+    }
+    sRtttlSoftwareTone.TicksToToggle = tTicks;
+}
+
+#if defined(__AVR__)
+/*
+ * The compare B interrupt of Timer1 is not used by tone() of the Arduino and ATTinyCore cores
+ */
+ISR(TIMER1_COMPB_vect) {
+    handleRtttlSoftwareToneTick();
+}
+#endif
+
+#if defined(TCCR1)
+// ATtiny25/45/85 8 bit Timer1 with prescaler bits n for 2^(n-1)
+constexpr uint8_t getRtttlSoftwareTonePrescalerBits(uint8_t aPrescalerBits = 1) {
+    return (RTTTL_SOFTWARE_TONE_TICK_CYCLES >> (aPrescalerBits - 1)) <= 256 ?
+            aPrescalerBits : getRtttlSoftwareTonePrescalerBits(aPrescalerBits + 1);
+}
+static_assert((RTTTL_SOFTWARE_TONE_TICK_CYCLES & ((1 << (getRtttlSoftwareTonePrescalerBits() - 1)) - 1)) == 0,
+        "RTTTL_SOFTWARE_TONE_TICK_CYCLES must be a multiple of the Timer1 prescaler");
+#endif
+
+/*
+ * Timer1 in CTC mode generates an interrupt every RTTTL_SOFTWARE_TONE_TICK_CYCLES, which toggles any pin.
+ * Only one tone at a time, Timer1 must not be used by other code, e.g. Servo or tone() on an ATtiny.
+ */
+struct RtttlOutputSoftwareTone {
+    static void begin(struct playRtttlState *aState) {
+        pinMode(aState->TonePin, OUTPUT);
+        silence(aState);
+        sRtttlSoftwareTone.PinInputRegister = portInputRegister(digitalPinToPort(aState->TonePin));
+        sRtttlSoftwareTone.PinMask = digitalPinToBitMask(aState->TonePin);
+#if defined(TCCR1)
+        TCCR1 = _BV(CTC1) | getRtttlSoftwareTonePrescalerBits(); // clear counter at OCR1C
+        OCR1C = (RTTTL_SOFTWARE_TONE_TICK_CYCLES >> (getRtttlSoftwareTonePrescalerBits() - 1)) - 1;
+        OCR1B = OCR1C; // one compare B match per cycle
+#else
+        TCCR1A = 0;
+        TCCR1B = _BV(WGM12) | _BV(CS10); // CTC mode with TOP = OCR1A, no prescaler
+        OCR1A = RTTTL_SOFTWARE_TONE_TICK_CYCLES - 1;
+        OCR1B = RTTTL_SOFTWARE_TONE_TICK_CYCLES - 1; // one compare B match per cycle
+#endif
+    }
+    /*
+     * The pin starts toggling at the next tick
+     */
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        (void) aState;
+        uint32_t tHalfPeriod = aNote->SoftwareToneHalfPeriod;
+        uint8_t tOldSREG = SREG;
+        cli();
+        sRtttlSoftwareTone.HalfPeriodTicks = tHalfPeriod >> 8;
+        sRtttlSoftwareTone.HalfPeriodFraction = tHalfPeriod;
+        sRtttlSoftwareTone.FractionSum = 0;
+        sRtttlSoftwareTone.TicksToToggle = 1;
+#if defined(TCCR1)
+        TIFR = _BV(OCF1B); // clear a pending interrupt
+        TIMSK |= _BV(OCIE1B);
+#else
+        TIFR1 = _BV(OCF1B);
+        TIMSK1 |= _BV(OCIE1B);
+#endif
+        SREG = tOldSREG;
+    }
+    static void silence(struct playRtttlState *aState) {
+#if defined(TCCR1)
+        TIMSK &= ~_BV(OCIE1B);
+#else
+        TIMSK1 &= ~_BV(OCIE1B);
+#endif
+        digitalWrite(aState->TonePin, aState->Flags.IsTonePinInverted ? HIGH : LOW);
+    }
+};
+#endif
+
+#if defined(USE_MIXER_OUTPUT) || defined(USE_WAVETABLE_OUTPUT)
+/*
+ * Timer1 as 8 bit PWM DAC with an overflow interrupt for each sample, used by RtttlOutputMixer and RtttlOutputWavetable
+ */
+#  if defined(USE_MIXER_OUTPUT)
+#define RTTTL_PWM_SAMPLE_RATE           RTTTL_MIXER_SAMPLE_RATE
+#  else
+#define RTTTL_PWM_SAMPLE_RATE           RTTTL_WAVETABLE_SAMPLE_RATE
+#  endif
+#define RTTTL_PWM_TOP                   (F_CPU / RTTTL_PWM_SAMPLE_RATE - 1)
+static_assert(RTTTL_PWM_TOP >= 0xFF && RTTTL_PWM_TOP <= 0xFFFF,
+        "The sample rate must be between F_CPU / 65536 and F_CPU / 256 for 8 bit duty cycles");
+
+/*
+ * Phase increment of the notes of octave NOTES_OCTAVE in 1/256, computed at compile time
+ */
+#define RTTTL_PHASE_INCREMENT(aNoteFrequency) \
+    ((uint32_t) (((aNoteFrequency) * (1ULL << 24) + RTTTL_PWM_SAMPLE_RATE / 2) / RTTTL_PWM_SAMPLE_RATE))
+const uint32_t RtttlPhaseIncrementTable[] PROGMEM = { RTTTL_PHASE_INCREMENT(NOTE_C7), RTTTL_PHASE_INCREMENT(NOTE_CS7),
+        RTTTL_PHASE_INCREMENT(NOTE_D7), RTTTL_PHASE_INCREMENT(NOTE_DS7), RTTTL_PHASE_INCREMENT(NOTE_E7),
+        RTTTL_PHASE_INCREMENT(NOTE_F7), RTTTL_PHASE_INCREMENT(NOTE_FS7), RTTTL_PHASE_INCREMENT(NOTE_G7),
+        RTTTL_PHASE_INCREMENT(NOTE_GS7), RTTTL_PHASE_INCREMENT(NOTE_A7), RTTTL_PHASE_INCREMENT(NOTE_AS7),
+        RTTTL_PHASE_INCREMENT(NOTE_B7) };
+
+/*
+ * Returns the value added to the 16 bit phase of a voice at each sample, for frequency = increment * RTTTL_PWM_SAMPLE_RATE / 65536.
+ * Frequencies above half of the sample rate are clamped to it.
+ */
+uint16_t getRtttlPhaseIncrement(uint8_t aNoteIndex, uint8_t aOctave) {
+    uint32_t tPhaseIncrement = pgm_read_dword(&RtttlPhaseIncrementTable[aNoteIndex]);
+    if (aOctave <= NOTES_OCTAVE) {
+        tPhaseIncrement >>= (NOTES_OCTAVE - aOctave);
+    } else {
+        tPhaseIncrement <<= (aOctave - NOTES_OCTAVE);
+    }
+    tPhaseIncrement = (tPhaseIncrement + 0x80) >> 8;
+    if (tPhaseIncrement > 0x8000) {
+        tPhaseIncrement = 0x8000;
+    }
+    return tPhaseIncrement;
+}
+
+/*
+ * Timer1 in fast PWM mode with TOP = ICR1 outputs the duty cycle on the OC1A or OC1B pin (9 or 10 on Uno / Nano).
+ * The pin of another player, which is already connected, stays connected.
+ */
+void beginRtttlTimer1Pwm(struct playRtttlState *aState) {
+    uint8_t tTimer = digitalPinToTimer(aState->TonePin);
+    uint8_t tCompareOutputMode = (tTimer == TIMER1A) ? _BV(COM1A1) : ((tTimer == TIMER1B) ? _BV(COM1B1) : 0);
+    if (aState->Flags.IsTonePinInverted) {
+        tCompareOutputMode |= tCompareOutputMode >> 1; // COM1A0 or COM1B0 for inverting mode
+    }
+    pinMode(aState->TonePin, OUTPUT);
+    ICR1 = RTTTL_PWM_TOP;
+    TCCR1A = (TCCR1A & (_BV(COM1A1) | _BV(COM1A0) | _BV(COM1B1) | _BV(COM1B0))) | tCompareOutputMode | _BV(WGM11);
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10); // fast PWM with TOP = ICR1, no prescaler
+}
+#endif
+
+#if defined(USE_MIXER_OUTPUT)
+#define RTTTL_MIXER_VOICE_AMPLITUDE     (255 / RTTTL_MIXER_NUMBER_OF_VOICES) // so the sum of all voices fits into 8 bit
+
+/*
+ * Phase accumulator of one voice, the highest bit of the phase is the square wave.
+ * A silent voice has phase and increment 0.
+ */
+struct rtttlMixerVoice {
+    uint16_t Phase;
+    uint16_t PhaseIncrement;
+};
+struct rtttlMixer {
+    struct rtttlMixerVoice Voices[RTTTL_MIXER_NUMBER_OF_VOICES];
+    struct playRtttlState *States[RTTTL_MIXER_NUMBER_OF_VOICES]; // The player of each voice
+} sRtttlMixer;
+
+static inline uint8_t getRtttlMixerVoiceLevel(struct rtttlMixerVoice *aVoice) {
+    uint16_t tPhase = aVoice->Phase + aVoice->PhaseIncrement;
+    aVoice->Phase = tPhase;
+    return (tPhase & 0x8000) ? RTTTL_MIXER_VOICE_AMPLITUDE : 0;
+}
+
+/*
+ * Called by the Timer1 overflow interrupt at RTTTL_MIXER_SAMPLE_RATE. Advances all voices and writes their sum as duty cycle.
+ * The voices are not in a loop, so all accesses use fixed addresses.
+ *
+ * Estimated cycles for an AVR, counted for the expected avr-gcc code, not measured:
+ * 7 cycles for interrupt response and vector jump, 16 for the prologue with 4 saved registers, 8 for writing OCR1A and OCR1B
+ * and 20 for the epilogue with reti, i.e. 51 cycles plus 16 cycles for each voice.
+ * This gives 83 cycles for 2, 99 for 3 and 115 for 4 voices, which is 16, 19 and 22 % CPU at 31250 Hz and 16 MHz.
+ */
+static inline void handleRtttlMixerSample() {
+    uint8_t tSum = getRtttlMixerVoiceLevel(&sRtttlMixer.Voices[0]) + getRtttlMixerVoiceLevel(&sRtttlMixer.Voices[1]);
+#if RTTTL_MIXER_NUMBER_OF_VOICES > 2
+    tSum += getRtttlMixerVoiceLevel(&sRtttlMixer.Voices[2]);
+#endif
+#if RTTTL_MIXER_NUMBER_OF_VOICES > 3
+    tSum += getRtttlMixerVoiceLevel(&sRtttlMixer.Voices[3]);
+#endif
+    // Only the pins connected in TCCR1A output the duty cycle
+    OCR1A = tSum;
+    OCR1B = tSum;
+}
+
+#if defined(__AVR__)
+ISR(TIMER1_OVF_vect) {
+    handleRtttlMixerSample();
+}
+#endif
+
+/*
+ * Timer1 outputs the sum of all voices as duty cycle, see beginRtttlTimer1Pwm().
+ * Each player gets its own voice at start of song, as long as a voice is free. A voice is free if its player is not running.
+ * The maximum duty cycle is 255 / (RTTTL_PWM_TOP + 1), i.e. 50 % at 16 MHz, which gives the loudest square wave if only one voice plays.
+ */
+struct RtttlOutputMixer {
+    static void begin(struct playRtttlState *aState) {
+        uint8_t tVoiceIndex = RTTTL_MIXER_NO_VOICE;
+        for (uint_fast8_t i = 0; i < RTTTL_MIXER_NUMBER_OF_VOICES; ++i) {
+            struct playRtttlState *tState = sRtttlMixer.States[i];
+            if (tState == aState) {
+                tVoiceIndex = i;
+                break;
+            }
+            if (tVoiceIndex == RTTTL_MIXER_NO_VOICE && (tState == nullptr || !tState->IsRunning)) {
+                tVoiceIndex = i;
+            }
+        }
+        aState->MixerVoiceIndex = tVoiceIndex;
+        if (tVoiceIndex == RTTTL_MIXER_NO_VOICE) {
+            return;
+        }
+        sRtttlMixer.States[tVoiceIndex] = aState;
+        silence(aState);
+        beginRtttlTimer1Pwm(aState);
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        if (aState->MixerVoiceIndex == RTTTL_MIXER_NO_VOICE) {
+            return;
+        }
+        uint8_t tOldSREG = SREG;
+        cli();
+        sRtttlMixer.Voices[aState->MixerVoiceIndex].PhaseIncrement = aNote->PhaseIncrement;
+        TIMSK1 |= _BV(TOIE1);
+        SREG = tOldSREG;
+    }
+    /*
+     * The interrupt is disabled if all voices are silent
+     */
+    static void silence(struct playRtttlState *aState) {
+        if (aState->MixerVoiceIndex == RTTTL_MIXER_NO_VOICE) {
+            return;
+        }
+        uint8_t tOldSREG = SREG;
+        cli();
+        struct rtttlMixerVoice *tVoice = &sRtttlMixer.Voices[aState->MixerVoiceIndex];
+        tVoice->Phase = 0;
+        tVoice->PhaseIncrement = 0;
+        bool tIsAnyVoicePlaying = false;
+        for (uint_fast8_t i = 0; i < RTTTL_MIXER_NUMBER_OF_VOICES; ++i) {
+            if (sRtttlMixer.Voices[i].PhaseIncrement != 0) {
+                tIsAnyVoicePlaying = true;
+            }
+        }
+        if (!tIsAnyVoicePlaying) {
+            TIMSK1 &= ~_BV(TOIE1);
+            OCR1A = 0;
+            OCR1B = 0;
+        }
+        SREG = tOldSREG;
+    }
+};
+#endif
+
+#if defined(USE_WAVETABLE_OUTPUT)
+// Compile time tables of the waveforms, the output levels and the envelope, generated by extras/host/RtttlWavetable
+#include "PlayRtttlWavetables.h"
+
+#define RTTTL_WAVETABLE_ZERO_DUTY       128 // Duty cycle of a zero sample, so positive and negative samples have 127 levels
+#define RTTTL_WAVETABLE_ENVELOPE_DIVIDER ((RTTTL_WAVETABLE_SAMPLE_RATE + 500) / 1000) // Samples per envelope step of about 1 ms
+#define RTTTL_WAVETABLE_ENVELOPE_STEP_MICROS (RTTTL_WAVETABLE_ENVELOPE_DIVIDER * 1000000UL / RTTTL_WAVETABLE_SAMPLE_RATE)
+#define RTTTL_WAVETABLE_MINIMUM_RELEASE_STEPS 2 // For style continuous, where the next note stops the release
+static_assert(RTTTL_WAVETABLE_ENVELOPE_DIVIDER <= 0xFF, "RTTTL_WAVETABLE_SAMPLE_RATE must be below 255 kHz");
+
+/*
+ * A sample of a wavetable is RTTTL_WAVETABLE_NEGATIVE | <attenuation>, with the attenuation in steps of 6 dB / 16.
+ * The envelope is an attenuation too, so the sample is multiplied with the envelope by adding both attenuations
+ * and looking up the level of the sum in RtttlWavetableLevels.
+ */
+struct rtttlWavetableVoice {
+    const uint8_t *Waveform;        // Wavetable in PROGMEM
+    const uint8_t *WaveformOfNextTone; // Set by setRtttlWaveform()
+    uint16_t Phase;
+    uint16_t PhaseIncrement;
+    uint8_t Attenuation;            // Of the envelope, RTTTL_WAVETABLE_SILENT if silent
+    uint8_t EnvelopeIndex;          // Of attack and decay in RtttlWavetableEnvelope
+    uint8_t ReleaseStep;            // Added to Attenuation at each envelope step, 0 during attack and decay
+    uint8_t ReleaseStepOfTone;      // Used by silence()
+    uint8_t EnvelopeDivider;        // Samples until the next envelope step
+} sRtttlWavetable = { RtttlWavetables[RTTTL_WAVEFORM_SINE], RtttlWavetables[RTTTL_WAVEFORM_SINE], 0, 0, RTTTL_WAVETABLE_SILENT, 0,
+        0, RTTTL_WAVETABLE_SILENT, RTTTL_WAVETABLE_ENVELOPE_DIVIDER };
+
+/*
+ * @param aWaveform RTTTL_WAVEFORM_SINE, RTTTL_WAVEFORM_TRIANGLE or RTTTL_WAVEFORM_PULSE_*
+ */
+void setRtttlWaveform(uint8_t aWaveform) {
+    if (aWaveform < RTTTL_NUMBER_OF_WAVEFORMS) {
+        sRtttlWavetable.WaveformOfNextTone = RtttlWavetables[aWaveform];
+    }
+}
+
+/*
+ * Returns the attenuation added at each envelope step of the release, so that the tone is silent at the end of the style gap.
+ * Thus the articulation of StyleDivisorValue determines the release, e.g. staccato has a long and natural a short release.
+ */
+uint8_t getRtttlWavetableReleaseStep(int32_t aGapMicros) {
+    int32_t tNumberOfSteps = aGapMicros / (int32_t) RTTTL_WAVETABLE_ENVELOPE_STEP_MICROS;
+    if (tNumberOfSteps < RTTTL_WAVETABLE_MINIMUM_RELEASE_STEPS) {
+        tNumberOfSteps = RTTTL_WAVETABLE_MINIMUM_RELEASE_STEPS;
+    }
+    if (tNumberOfSteps >= RTTTL_WAVETABLE_SILENT) {
+        return 1;
+    }
+    return (RTTTL_WAVETABLE_SILENT + (uint8_t) tNumberOfSteps - 1) / (uint8_t) tNumberOfSteps;
+}
+
+/*
+ * Attack and decay are read from RtttlWavetableEnvelope, decay ends with its last value, the sustain level.
+ * The release only adds ReleaseStep. The interrupt is disabled at the end of the release.
+ */
+static inline void stepRtttlWavetableEnvelope() {
+    if (sRtttlWavetable.ReleaseStep != 0) {
+        uint8_t tAttenuation = sRtttlWavetable.Attenuation + sRtttlWavetable.ReleaseStep;
+        if (tAttenuation >= RTTTL_WAVETABLE_SILENT) {
+            tAttenuation = RTTTL_WAVETABLE_SILENT;
+            TIMSK1 &= ~_BV(TOIE1);
+            OCR1A = RTTTL_WAVETABLE_ZERO_DUTY;
+            OCR1B = RTTTL_WAVETABLE_ZERO_DUTY;
+        }
+        sRtttlWavetable.Attenuation = tAttenuation;
+    } else if (sRtttlWavetable.EnvelopeIndex < RTTTL_WAVETABLE_ENVELOPE_LENGTH - 1) {
+        sRtttlWavetable.EnvelopeIndex++;
+        sRtttlWavetable.Attenuation = pgm_read_byte(&RtttlWavetableEnvelope[sRtttlWavetable.EnvelopeIndex]);
+    }
+}
+
+/*
+ * Called by the Timer1 overflow interrupt at RTTTL_WAVETABLE_SAMPLE_RATE. Writes the next sample of the wavetable
+ * with the attenuation of the envelope as duty cycle. Only additions, shifts and table lookups, no multiplication.
+ *
+ * Estimated cycles for an AVR, counted for the expected avr-gcc code, not measured:
+ * 7 cycles for interrupt response and vector jump, 24 for the prologue with 6 saved registers, 12 for the phase,
+ * 12 for the wavetable lookup, 10 for adding the attenuations and the level lookup, 5 for the sign, 8 for writing OCR1A and OCR1B,
+ * 8 for the envelope divider and 24 for the epilogue with reti, i.e. 110 cycles and additionally 25 cycles for each envelope step.
+ * This is 22 % CPU at 31250 Hz and 16 MHz.
+ */
+static inline void handleRtttlWavetableSample() {
+    uint16_t tPhase = sRtttlWavetable.Phase + sRtttlWavetable.PhaseIncrement;
+    sRtttlWavetable.Phase = tPhase;
+    uint8_t tSample = pgm_read_byte(&sRtttlWavetable.Waveform[tPhase >> (16 - RTTTL_WAVETABLE_SIZE_SHIFT)]);
+    uint8_t tAttenuation = (tSample & RTTTL_WAVETABLE_ATTENUATION_MASK) + sRtttlWavetable.Attenuation;
+    uint8_t tLevel = 0;
+    if (tAttenuation < RTTTL_WAVETABLE_SILENT) {
+        tLevel = pgm_read_byte(&RtttlWavetableLevels[tAttenuation]);
+    }
+    uint8_t tDuty = (tSample & RTTTL_WAVETABLE_NEGATIVE) ? RTTTL_WAVETABLE_ZERO_DUTY - tLevel : RTTTL_WAVETABLE_ZERO_DUTY + tLevel;
+    // Only the pin connected in TCCR1A outputs the duty cycle
+    OCR1A = tDuty;
+    OCR1B = tDuty;
+    if (--sRtttlWavetable.EnvelopeDivider == 0) {
+        sRtttlWavetable.EnvelopeDivider = RTTTL_WAVETABLE_ENVELOPE_DIVIDER;
+        stepRtttlWavetableEnvelope();
+    }
+}
+
+#if defined(__AVR__)
+ISR(TIMER1_OVF_vect) {
+    handleRtttlWavetableSample();
+}
+#endif
+
+/*
+ * Timer1 outputs the samples as duty cycle, see beginRtttlTimer1Pwm(). The duty cycle is 128 / (RTTTL_PWM_TOP + 1) for silence,
+ * i.e. 25 % at 16 MHz, so the tones start and end without a click.
+ * Each tone starts with an attack and decays to the sustain level. At the end of the tone, silence() starts the release.
+ * If the next tone starts before the end of the release, e.g. for style continuous, it continues with the same phase
+ * and at the point of the attack with the current level.
+ */
+struct RtttlOutputWavetable {
+    static void begin(struct playRtttlState *aState) {
+        if (!(TIMSK1 & _BV(TOIE1))) {
+            // Not in the release of a stopped song
+            OCR1A = RTTTL_WAVETABLE_ZERO_DUTY;
+            OCR1B = RTTTL_WAVETABLE_ZERO_DUTY;
+        }
+        beginRtttlTimer1Pwm(aState);
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+        (void) aState;
+        uint8_t tOldSREG = SREG;
+        cli();
+        uint8_t tEnvelopeIndex = 0;
+        if (sRtttlWavetable.Attenuation == RTTTL_WAVETABLE_SILENT) {
+            sRtttlWavetable.Phase = 0; // all waveforms start at the zero crossing or at the start of the pulse
+        } else {
+            while (tEnvelopeIndex < RTTTL_WAVETABLE_ATTACK_LENGTH - 1
+                    && pgm_read_byte(&RtttlWavetableEnvelope[tEnvelopeIndex]) > sRtttlWavetable.Attenuation) {
+                tEnvelopeIndex++;
+            }
+        }
+        sRtttlWavetable.Waveform = sRtttlWavetable.WaveformOfNextTone;
+        sRtttlWavetable.PhaseIncrement = aNote->PhaseIncrement;
+        sRtttlWavetable.EnvelopeIndex = tEnvelopeIndex;
+        sRtttlWavetable.Attenuation = pgm_read_byte(&RtttlWavetableEnvelope[tEnvelopeIndex]);
+        sRtttlWavetable.ReleaseStep = 0;
+        sRtttlWavetable.ReleaseStepOfTone = aNote->WavetableReleaseStep;
+        TIMSK1 |= _BV(TOIE1);
+        SREG = tOldSREG;
+    }
+    /*
+     * Starts the release, the interrupt ends it
+     */
+    static void silence(struct playRtttlState *aState) {
+        (void) aState;
+        sRtttlWavetable.ReleaseStep = sRtttlWavetable.ReleaseStepOfTone; // a byte, so no cli() required
+    }
+};
+#endif
+
+#if defined(USE_PWM_OUTPUT)
+/*
+ * analogWrite() with 50 % duty cycle at the frequency of the note.
+ * The RP2040 core sets the frequency for all PWM pins and supports only frequencies from 100 Hz.
+ */
+struct RtttlOutputPWM {
+    static void begin(struct playRtttlState *aState) {
+        pinMode(aState->TonePin, OUTPUT);
+        silence(aState);
+    }
+    static void start(struct playRtttlState *aState, struct rtttlPreparedNote *aNote) {
+#  if defined(TEENSYDUINO)
+        analogWriteFrequency(aState->TonePin, aNote->Frequency);
+#  elif defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)
+        analogWriteFreq(aNote->Frequency);
+#  else
+#error USE_PWM_OUTPUT is only supported for the Teensy and the RP2040 core of Earle Philhower
+#  endif
+        analogWrite(aState->TonePin, 128); // 50 % of the default 8 bit resolution
+    }
+    static void silence(struct playRtttlState *aState) {
+        analogWrite(aState->TonePin, aState->Flags.IsTonePinInverted ? 255 : 0);
+    }
+};
+#endif
+
 #define isdigit(n) (n >= '0' && n <= '9')
 
-uint8_t sDefaultStyleDivisorValue = RTTTL_STYLE_DEFAULT; // Natural (16)
+uint8_t sDefaultStyleDivisorValue = RTTTL_STYLE_DEFAULT; // Natural (16)
+
+/*
+ * Blocking versions
+ */
+void playRtttlBlocking(uint8_t aTonePin, const char *aRTTTLArrayPtr) {
+    startPlayRtttl(aTonePin, aRTTTLArrayPtr, nullptr);
+    while (updatePlayRtttl()) {
+        delay(1); // this in turn calls yield();
+    }
+}
+
+/*
+ * Like playRtttlBlocking(), but updatePlayRtttl() is only called when the next action is due
+ * and the CPU sleeps in between, see sleepUntilPlayRtttlNextAction().
+ */
+void playRtttlBlockingLowPower(uint8_t aTonePin, const char *aRTTTLArrayPtr) {
+    startPlayRtttl(aTonePin, aRTTTLArrayPtr, nullptr);
+    while (updatePlayRtttl()) {
+        sleepUntilPlayRtttlNextAction();
+    }
+}
+
+/*
+ * Sets the values used if they are not specified in the RTTTL header.
+ * For struct playRtttlState and struct rtttlDecodeState.
+ */
+template<typename State>
+void setRtttlHeaderDefaults(State *aState) {
+    aState->DefaultDuration = DEFAULT_DURATION;
+    aState->DefaultOctave = DEFAULT_OCTAVE;
+    aState->BeatsPerMinute = DEFAULT_BPM;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    aState->NumberOfLoops = 1;
+    aState->StyleDivisorValue = sDefaultStyleDivisorValue;
+#endif
+}
+
+/*
+ * Returns the duration of the tone output in milliseconds for a note duration in microseconds
+ */
+unsigned long computeRtttlDurationOfTone(struct playRtttlState *aState, unsigned long aDuration) {
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    if (aState->StyleDivisorValue != 0) {
+        /*
+         * handle style parameter, compute duration of tone output for note and do rounding for integer division
+         */
+        aDuration -= (aDuration + (aState->StyleDivisorValue / 2)) / aState->StyleDivisorValue;
+    }
+#else
+    (void) aState;
+    // even without INTERPRETE_RTX_FORMAT the default style is natural (Tone length = note length - 1/16)
+    aDuration -= (aDuration >> 4);
+#endif
+    return (aDuration + 500) / 1000; // tone() requires milliseconds
+}
+
+/*
+ * Computes the time for a whole note and the duration table from BPM and style.
+ * To be called after BeatsPerMinute and StyleDivisorValue are set.
+ */
+void initRtttlDurations(struct playRtttlState *aState) {
+    // BPM usually expresses the number of quarter notes per minute
+    aState->TimeForWholeNoteMicros = RTTTL_WHOLE_NOTE_MICROS_AT_ONE_BPM / aState->BeatsPerMinute;
+#if !defined(USE_NO_DURATION_TABLE)
+    for (uint_fast8_t tExponent = 0; tExponent < RTTTL_DURATION_TABLE_EXPONENTS; ++tExponent) {
+        unsigned long tDuration = aState->TimeForWholeNoteMicros >> tExponent;
+        for (uint_fast8_t tNumberOfDots = 0; tNumberOfDots < RTTTL_DURATION_TABLE_DOTS; ++tNumberOfDots) {
+            struct rtttlDurationTableEntry *tEntry = &aState->DurationTable[tExponent][tNumberOfDots];
+            tEntry->Duration = tDuration;
+            tEntry->DurationOfTone = computeRtttlDurationOfTone(aState, tDuration);
+            tDuration += tDuration / 2;
+        }
+    }
+#endif
+}
+
+/*
+ * Minimal state for decoding a song in RAM or FLASH without playing it, e.g. by getRtttlInfo().
+ * It has only the header values, so it requires 10 bytes of stack instead of the more than 100 bytes of playRtttlState.
+ */
+struct rtttlDecodeState {
+    uint8_t DefaultDuration;
+    uint8_t DefaultOctave;
+    uint16_t BeatsPerMinute;
+    unsigned long TimeForWholeNoteMicros;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    uint8_t NumberOfLoops;
+    uint8_t StyleDivisorValue;
+#endif
+};
+
+/*
+ * Called by parseRtttlHeader(), no duration table for decoding
+ */
+void initRtttlDurations(struct rtttlDecodeState *aState) {
+    aState->TimeForWholeNoteMicros = RTTTL_WHOLE_NOTE_MICROS_AT_ONE_BPM / aState->BeatsPerMinute;
+}
+
+/*
+ * Same duration as computed by prepareNextRtttlNote()
+ */
+unsigned long computeRtttlNoteDuration(struct rtttlDecodeState *aState, struct rtttlNote *aNote) {
+    unsigned long tDuration = aState->TimeForWholeNoteMicros / aNote->DurationNumber;
+    for (uint_fast8_t i = 0; i < aNote->NumberOfDots; ++i) {
+        tDuration += tDuration / 2;
+    }
+    return tDuration;
+}
+
+/*
+ * Character sources for the RTTTL parser.
+ * The source is a template parameter of the parser, so the memory type is resolved at compile time
+ * and reading a character is a single inlined load instead of a runtime check for each character.
+ */
+struct RtttlSourceRAM {
+    template<typename State>
+    static char readChar(State *aState __attribute__((unused)), rtttlAddress_t aAddress) {
+        return *(const char*) aAddress;
+    }
+};
+
+struct RtttlSourcePGM {
+    template<typename State>
+    static char readChar(State *aState __attribute__((unused)), rtttlAddress_t aAddress) {
+        return pgm_read_byte((const char* ) aAddress);
+    }
+};
+
+struct RtttlSourceFarPGM {
+    template<typename State>
+    static char readChar(State *aState __attribute__((unused)), rtttlAddress_t aAddress) {
+#if defined(__AVR__) && defined(RAMPZ)
+        return pgm_read_byte_far(aAddress);
+#else
+        return pgm_read_byte((const char* ) aAddress);
+#endif
+    }
+};
+
+#if defined(__AVR__)
+struct RtttlSourceEEPROM {
+    static char readChar(struct playRtttlState *aState __attribute__((unused)), rtttlAddress_t aAddress) {
+        return eeprom_read_byte((const uint8_t*) aAddress);
+    }
+};
+#endif
+
+struct RtttlSourceCallback {
+    static char readChar(struct playRtttlState *aState, rtttlAddress_t aAddress) {
+        return aState->ReadCharFunction(aAddress);
+    }
+};
+
+/*
+ * Reads the header of RTTTL data and sets the values specified there.
+ * Values not specified must be set before, e.g. by setRtttlHeaderDefaults().
+ * State is struct playRtttlState or, for the sources RAM and PGM, struct rtttlDecodeState.
+ * @return address of the first note
+ */
+template<typename Source, typename State>
+rtttlAddress_t parseRtttlHeader(State *aState, rtttlAddress_t aAddress) {
+    int tNumber;
+
+    /*
+     * Skip name and :
+     */
+#if defined(LOCAL_DEBUG)
+    sPointerToSerial->print(F("Title="));
+#endif
+    char tChar = Source::readChar(aState, aAddress);
+    while (tChar != ':') {
+        /*
+         * Read title
+         */
+#if defined(LOCAL_DEBUG)
+        sPointerToSerial->print(tChar);
+#endif
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    }
+
+#if !defined(USE_NO_RTX_EXTENSIONS)
+#if defined(LOCAL_DEBUG)
+    char tStyleChar = RTX_STYLE_DEFAULT;
+#else
+    char tStyleChar;
+#endif
+#endif
+    int tBPM = 0;
+
+    do {
+        /*
+         * Get character after separator (comma or colon)
+         */
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+        /*
+         * Read song info with format: d=N(N),o=N,b=NNN:
+         */
+        if (tChar == 'd') {
+            /*
+             * get default duration
+             */
+            aAddress += 2;              // skip "d="
+            tChar = Source::readChar(aState, aAddress);
+            tNumber = 0;
+            while (isdigit(tChar)) {
+                tNumber = (tNumber * 10) + (tChar - '0');
+                aAddress++;
+                tChar = Source::readChar(aState, aAddress);
+            }
+            if (tNumber == 0) {
+                tNumber = DEFAULT_DURATION;
+            }
+            aState->DefaultDuration = tNumber;
+        } else if (tChar == 'o') {
+            /*
+             * get default octave
+             */
+            aAddress += 2;              // skip "o="
+            tNumber = Source::readChar(aState, aAddress) - '0';
+            if (tNumber < 3 || tNumber > 7) {
+                tNumber = DEFAULT_OCTAVE; // Also for a non digit character
+            }
+            aState->DefaultOctave = tNumber;
+            //get comma or colon
+            aAddress++;
+            tChar = Source::readChar(aState, aAddress);
+        } else
+
+#if !defined(USE_NO_RTX_EXTENSIONS)
+        if (tChar == 's') {
+            // get Style
+            aAddress += 2;              // skip "s="
+            tStyleChar = Source::readChar(aState, aAddress);
+            tNumber = convertStyleCharacterToDivisorValue(tStyleChar);
+            aState->StyleDivisorValue = tNumber;
+            //get comma or colon
+            aAddress++;
+            tChar = Source::readChar(aState, aAddress);
+        } else if (tChar == 'l') {
+            // get loops
+            aAddress += 2;              // skip "l="
+            tChar = Source::readChar(aState, aAddress);
+            tNumber = 0;
+            while (isdigit(tChar)) {
+                tNumber = (tNumber * 10) + (tChar - '0');
+                aAddress++;
+                tChar = Source::readChar(aState, aAddress);
+            }
+            if (tNumber == 15) {
+                tNumber = 0;
+            }
+            aState->NumberOfLoops = tNumber;
+        } else
+#endif
+
+        // get BPM
+        if (tChar == 'b') {
+            aAddress += 2;              // skip "b="
+            tChar = Source::readChar(aState, aAddress);
+            while (isdigit(tChar)) {
+                tBPM = (tBPM * 10) + (tChar - '0');
+                aAddress++;
+                tChar = Source::readChar(aState, aAddress);
+            }
+            if (tBPM == 0) {
+                tBPM = DEFAULT_BPM;
+            }
+            aState->BeatsPerMinute = tBPM;
+        }
+
+    } while (tChar != ':');
+
+    aAddress++; // skip colon
+
+    initRtttlDurations(aState);
+
+#if defined(LOCAL_DEBUG)
+    sPointerToSerial->print(F(" DefaultDuration="));
+    sPointerToSerial->print(aState->DefaultDuration);
+    sPointerToSerial->print(F(" DefaultOctave="));
+    sPointerToSerial->print(aState->DefaultOctave);
+    sPointerToSerial->print(F(" BPM="));
+    sPointerToSerial->print(tBPM);
+#  if !defined(USE_NO_RTX_EXTENSIONS)
+    sPointerToSerial->print(F(" Style="));
+    sPointerToSerial->print(tStyleChar);
+    if (aState->StyleDivisorValue != 0) {
+        sPointerToSerial->print(F(" -> 1/"));
+        sPointerToSerial->print(aState->StyleDivisorValue);
+        sPointerToSerial->print(F(" pause between notes,"));
+    }
+    sPointerToSerial->print(F(" Loops="));
+    sPointerToSerial->print(aState->NumberOfLoops);
+#  endif
+    sPointerToSerial->println();
+#endif
+    return aAddress;
+}
+
+/*
+ * Parses one note of RTTTL text. Default duration and octave are taken from aState.
+ * @return address of the next note or of the terminating null
+ */
+template<typename Source, typename State>
+rtttlAddress_t parseRtttlNote(State *aState, rtttlAddress_t aAddress, struct rtttlNote *aNote) {
+    char tChar = Source::readChar(aState, aAddress);
+
+// first, get note duration, if available
+    uint8_t tDurationNumber = 0;
+    while (isdigit(tChar)) {
+        tDurationNumber = (tDurationNumber * 10) + (tChar - '0');
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    }
+
+    if (tDurationNumber == 0) {
+        tDurationNumber = aState->DefaultDuration; // we will need to check if we are a dotted note after
+    }
+    aNote->DurationNumber = tDurationNumber;
+    aNote->NumberOfDots = 0;
+
+// now get the note
+    uint8_t tNote;
+    switch (tChar) {
+    case 'c':
+        tNote = 0;
+        break;
+    case 'd':
+        tNote = 2;
+        break;
+    case 'e':
+        tNote = 4;
+        break;
+    case 'f':
+        tNote = 5;
+        break;
+    case 'g':
+        tNote = 7;
+        break;
+    case 'a':
+        tNote = 9;
+        break;
+    case 'b':
+    case 'h':  // I have seen this
+        tNote = 11;
+        break;
+    case 'p':
+    default:
+        tNote = 42; // pause
+    }
+
+    aAddress++;
+    tChar = Source::readChar(aState, aAddress);
+
+    // now, get optional '#' sharp (or '_' as seen on many songs)
+    if (tChar == '#' || tChar == '_') {
+        tNote++;
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    }
+    aNote->Note = tNote;
+
+// now, get optional '.' of dotted note
+    if (tChar == '.') {
+        aNote->NumberOfDots++;
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    }
+
+// now, get octave
+    if (isdigit(tChar)) {
+        aNote->Octave = tChar - '0';
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    } else {
+        aNote->Octave = aState->DefaultOctave;
+    }
+
+    if (tChar == '.') {         // believe me I have seen this (e.g. in SilentNight)
+        aNote->NumberOfDots++;
+        aAddress++;
+        tChar = Source::readChar(aState, aAddress);
+    }
+
+    if (tChar == ',') {
+        aAddress++;       // skip comma for next note (or we may be at the end)
+    }
+    return aAddress;
+}
+
+/*
+ * Parses the note at NextTonePointer and advances NextTonePointer.
+ * This is the function stored in ParseNextNote for playing RTTTL text.
+ * @return RTTTL_PARSE_OK or RTTTL_PARSE_END_OF_SONG
+ */
+template<typename Source>
+uint8_t parseNextRtttlNote(struct playRtttlState *aState, struct rtttlNote *aNote) {
+    if (Source::readChar(aState, aState->NextTonePointer) == '\0') {
+        return RTTTL_PARSE_END_OF_SONG;
+    }
+    aState->NextTonePointer = parseRtttlNote<Source>(aState, aState->NextTonePointer, aNote);
+    return RTTTL_PARSE_OK;
+}
+
+/*
+ * Initializes the pointers to the first note and plays it
+ * If updated from interrupt, the first note is played at the next interrupt
+ */
+void RtttlPlayer::startAtFirstNote(rtttlAddress_t aFirstNoteAddress) {
+    RTTTL_OUTPUT::begin(&State);
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    State.IsToneOn = false;
+#endif
+    State.MicrosOfNextAction = micros();
+    State.NextTonePointer = aFirstNoteAddress;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    State.LastTonePointer = aFirstNoteAddress;
+#endif
+    State.IsCompletionPending = false;
+    State.NumberOfShortenedNotes = 0;
+    State.NumberOfDroppedNotes = 0;
+
+    /*
+     * Decode first tone before setting IsRunning, because updateFromInterrupt() may play it immediately after
+     */
+    prepareNextRtttlNote(&State);
+    State.IsRunning = true;
+    update();
+}
+
+/*
+ * Common start function for all character sources
+ */
+template<typename Source>
+void RtttlPlayer::startFromSource(uint8_t aTonePin, rtttlAddress_t aAddress, bool aIsPGMMemory, void (*aOnComplete)()) {
+    State.IsRunning = false; // keep updateFromInterrupt() off the state until it is set up
+    State.Flags.IsPGMMemory = aIsPGMMemory;
+    State.Flags.IsCompiled = false;
+    State.ParseNextNote = &parseNextRtttlNote<Source>;
+    State.OnComplete = aOnComplete;
+    State.TonePin = aTonePin;
+
+    setRtttlHeaderDefaults(&State);
+    startAtFirstNote(parseRtttlHeader<Source>(&State, aAddress));
+}
+
+/*
+ * Version for RTTTL Data in RAM. Ie. you must call update() in your loop.
+ */
+void RtttlPlayer::start(uint8_t aTonePin, const char *aRTTTLArrayPtr, void (*aOnComplete)()) {
+    startFromSource<RtttlSourceRAM>(aTonePin, (rtttlAddress_t) aRTTTLArrayPtr, false, aOnComplete);
+}
+
+void startPlayRtttl(uint8_t aTonePin, const char *aRTTTLArrayPtr, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.start(aTonePin, aRTTTLArrayPtr, aOnComplete);
+}
+
+bool RtttlPlayer::isRunning() {
+    return State.IsRunning;
+}
+
+bool isPlayRtttlRunning() {
+    return sDefaultRtttlPlayer.isRunning();
+}
+
+void RtttlPlayer::stop() {
+    State.IsRunning = false; // first, so that updateFromInterrupt() can not start a new tone after silence()
+    RTTTL_OUTPUT::silence(&State);
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    State.IsToneOn = false;
+#endif
+}
+
+void stopPlayRtttl(void) {
+    sDefaultRtttlPlayer.stop();
+}
+
+uint16_t getNextWordFromCompiledArray(struct playRtttlState *aState, const uint16_t *aCompiledArrayPtr) {
+    if (aState->Flags.IsPGMMemory) {
+        return pgm_read_word(aCompiledArrayPtr);
+    }
+    return *aCompiledArrayPtr;
+}
+
+/*
+ * Returns the frequency for the note index 0 to 11 of Notes[] and the octave
+ */
+uint16_t getRtttlFrequency(uint8_t aNoteIndex, uint8_t aOctave) {
+#if defined(__AVR__)
+    uint16_t tFrequency = pgm_read_word(&Notes[aNoteIndex]);
+#else
+    uint16_t tFrequency = Notes[aNoteIndex];
+#endif
+    if (aOctave <= NOTES_OCTAVE) {
+        tFrequency >>= (NOTES_OCTAVE - aOctave);
+    } else {
+        tFrequency <<= (aOctave - NOTES_OCTAVE);
+    }
+    return tFrequency;
+}
+
+/*
+ * Reads and decodes the next note into aState->NextNote.
+ * Called directly after the current note was started, so all parsing, divisions and frequency computation
+ * are done while the current note is playing, and not at the time the next note is due.
+ * End of song with remaining loops is handled here too, so the first note of the next loop is also prepared in advance.
+ */
+void prepareNextRtttlNote(struct playRtttlState *aState) {
+    struct rtttlPreparedNote *tNextNote = &aState->NextNote;
+    uint16_t tCompiledNote = 0;
+    struct rtttlNote tParsedNote;
+    uint8_t tParseResult;
+
+    /*
+     * Check if end of song reached, for RTTTL text parse the note
+     */
+    if (aState->Flags.IsCompiled) {
+        tCompiledNote = getNextWordFromCompiledArray(aState, (const uint16_t*) aState->NextTonePointer);
+        tParseResult = (tCompiledNote == RTTTL_COMPILED_END) ? RTTTL_PARSE_END_OF_SONG : RTTTL_PARSE_OK;
+    } else {
+        tParseResult = aState->ParseNextNote(aState, &tParsedNote);
+    }
+
+    if (tParseResult == RTTTL_PARSE_END_OF_SONG) {
+#if !defined(USE_NO_RTX_EXTENSIONS)
+        uint8_t tNumberOfLoops = aState->NumberOfLoops;
+        if (tNumberOfLoops > 1) {
+            aState->NumberOfLoops--;
+        }
+        if (tNumberOfLoops != 1) {
+            // loop again
+#  if defined(USE_RTTTL_STATISTICS)
+            aState->Statistics.NumberOfLoopRestarts++;
+#  endif
+#  if defined(LOCAL_DEBUG)
+            sPointerToSerial->print(F("Loop count="));
+            sPointerToSerial->println(aState->NumberOfLoops);
+#  endif
+            aState->NextTonePointer = aState->LastTonePointer;
+            prepareNextRtttlNote(aState);
+            return;
+        }
+#endif // USE_NO_RTX_EXTENSIONS
+    }
+    tNextNote->ParseResult = tParseResult;
+    if (tParseResult != RTTTL_PARSE_OK) {
+        return;
+    }
+
+    uint8_t tNote;
+    uint8_t tOctave;
+    uint8_t tNumberOfDots;
+    uint8_t tDurationExponent;
+    if (aState->Flags.IsCompiled) {
+        /*
+         * Compiled format, only bit extraction, no parsing
+         */
+        tNote = tCompiledNote & RTTTL_COMPILED_NOTE_MASK;
+        tOctave = (tCompiledNote >> RTTTL_COMPILED_OCTAVE_SHIFT) & RTTTL_COMPILED_OCTAVE_MASK;
+        tDurationExponent = (tCompiledNote >> RTTTL_COMPILED_DURATION_SHIFT) & RTTTL_COMPILED_DURATION_MASK;
+        tNumberOfDots = (tCompiledNote >> RTTTL_COMPILED_DOTS_SHIFT) & RTTTL_COMPILED_DOTS_MASK;
+        aState->NextTonePointer += sizeof(uint16_t);
+    } else {
+        tNote = tParsedNote.Note;
+        tOctave = tParsedNote.Octave;
+        tNumberOfDots = tParsedNote.NumberOfDots;
+        // Get exponent for power of 2 durations, other durations get an exponent of 0xFF
+        tDurationExponent = 0;
+        while ((1 << tDurationExponent) < tParsedNote.DurationNumber) {
+            tDurationExponent++;
+        }
+        if ((1 << tDurationExponent) != tParsedNote.DurationNumber) {
+            tDurationExponent = 0xFF;
+        }
+    }
+
+#if !defined(USE_NO_DURATION_TABLE)
+    if (tDurationExponent < RTTTL_DURATION_TABLE_EXPONENTS && tNumberOfDots < RTTTL_DURATION_TABLE_DOTS) {
+        /*
+         * Common case, just copy the durations from the table
+         */
+        struct rtttlDurationTableEntry *tEntry = &aState->DurationTable[tDurationExponent][tNumberOfDots];
+        tNextNote->Duration = tEntry->Duration;
+        tNextNote->DurationOfTone = tEntry->DurationOfTone;
+    } else
+#endif
+    {
+        unsigned long tDuration;
+        if (tDurationExponent == 0xFF) {
+            tDuration = aState->TimeForWholeNoteMicros / tParsedNote.DurationNumber;
+        } else {
+            tDuration = aState->TimeForWholeNoteMicros >> tDurationExponent;
+        }
+        while (tNumberOfDots > 0) {
+            tDuration += tDuration / 2;
+            tNumberOfDots--;
+        }
+        tNextNote->Duration = tDuration;
+        tNextNote->DurationOfTone = computeRtttlDurationOfTone(aState, tDuration);
+    }
+
+    if (tNote <= 12) {
+        if (tNote == 12) {
+            // b# is c of the next octave
+            tNote = 0;
+            tOctave++;
+        }
+        tNextNote->Frequency = getRtttlFrequency(tNote, tOctave);
+#if defined(USE_DIRECT_TIMER2_OUTPUT)
+        if (tOctave >= RTTTL_TIMER2_TABLE_OCTAVES) {
+            tOctave = RTTTL_TIMER2_TABLE_OCTAVES - 1;
+        }
+        tNextNote->Timer2Entry = pgm_read_word(&RtttlTimer2Table[tOctave][tNote]);
+#endif
+#if defined(USE_SOFTWARE_TONE_OUTPUT)
+        tNextNote->SoftwareToneHalfPeriod = getRtttlSoftwareToneHalfPeriod(tNote, tOctave);
+#endif
+#if defined(USE_MIXER_OUTPUT) || defined(USE_WAVETABLE_OUTPUT)
+        tNextNote->PhaseIncrement = getRtttlPhaseIncrement(tNote, tOctave);
+#endif
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+        tNextNote->DurationOfToneMicros = tNextNote->DurationOfTone * 1000UL;
+#endif
+#if defined(USE_WAVETABLE_OUTPUT)
+        tNextNote->WavetableReleaseStep = getRtttlWavetableReleaseStep(tNextNote->Duration - tNextNote->DurationOfToneMicros);
+#endif
+    } else {
+        // pause
+        tNextNote->Frequency = 0;
+    }
+}
+
+#if defined(USE_RTTTL_STATISTICS)
+// The index of the ring buffer is wrapped by masking
+static_assert(RTTTL_STATISTICS_NUMBER_OF_RECORDS != 0
+        && (RTTTL_STATISTICS_NUMBER_OF_RECORDS & (RTTTL_STATISTICS_NUMBER_OF_RECORDS - 1)) == 0
+        && RTTTL_STATISTICS_NUMBER_OF_RECORDS <= 256, "RTTTL_STATISTICS_NUMBER_OF_RECORDS must be a power of 2 and at most 256");
+/*
+ * Called at start of each note. Only stores binary values, they are printed later by printStatistics().
+ */
+void recordRtttlNoteStatistics(struct playRtttlState *aState, uint32_t aScheduledMicros, uint32_t aActualMicros) {
+    struct rtttlStatistics *tStatistics = &aState->Statistics;
+    uint32_t tLatenessMicros = aActualMicros - aScheduledMicros;
+    tStatistics->NumberOfNotes++;
+    tStatistics->SumOfLatenessMicros += tLatenessMicros;
+    if (tStatistics->MaximumLatenessMicros < tLatenessMicros) {
+        tStatistics->MaximumLatenessMicros = tLatenessMicros;
+    }
+    if (tLatenessMicros > RTTTL_LATE_NOTE_MICROS) {
+        tStatistics->NumberOfLateNotes++;
+    }
+
+    // Logarithmic bins, so no division is required
+    uint8_t tBin = 0;
+    tLatenessMicros /= RTTTL_LATENESS_HISTOGRAM_FIRST_BIN_MICROS;
+    while (tLatenessMicros != 0 && tBin < RTTTL_LATENESS_HISTOGRAM_BINS - 1) {
+        tLatenessMicros >>= 1;
+        tBin++;
+    }
+    tStatistics->LatenessHistogram[tBin]++;
+
+    struct rtttlNoteRecord *tRecord = &tStatistics->Records[tStatistics->IndexOfNextRecord];
+    tStatistics->IndexOfNextRecord = (tStatistics->IndexOfNextRecord + 1) & (RTTTL_STATISTICS_NUMBER_OF_RECORDS - 1);
+    tRecord->ScheduledMicros = aScheduledMicros;
+    tRecord->ActualMicros = aActualMicros;
+    tRecord->Duration = aState->NextNote.Duration;
+    tRecord->Frequency = aState->NextNote.Frequency;
+}
+#endif
+
+/*
+ * Outputs the prepared tone or pause and sets the time for the next action
+ */
+template<typename Output>
+void playPreparedRtttlNote(struct playRtttlState *aState) {
+    struct rtttlPreparedNote *tNextNote = &aState->NextNote;
+    if (tNextNote->Frequency != 0) {
+        Output::start(aState, tNextNote);
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+        aState->MicrosOfToneEnd = aState->MicrosOfNextAction + tNextNote->DurationOfToneMicros;
+        aState->IsToneOn = true;
+#endif
+    } else {
+        Output::silence(aState);
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+        aState->IsToneOn = false;
+#endif
+    }
+    aState->MicrosOfNextAction += tNextNote->Duration;
+
+#if defined(TRACE)
+    sPointerToSerial->print(F("Playing: "));
+    if (tNextNote->Frequency != 0) {
+        sPointerToSerial->print(tNextNote->Frequency, 10);
+        sPointerToSerial->print(F(" Hz for "));
+        sPointerToSerial->print(tNextNote->DurationOfTone, 10);
+        sPointerToSerial->print(F(" of "));
+    } else {
+        sPointerToSerial->print(F("pause for "));
+    }
+    sPointerToSerial->print(tNextNote->Duration / 1000, 10);
+    sPointerToSerial->println(F(" ms"));
+#endif //TRACE
+}
+
+/*
+ * Applies RTTTL_LATE_POLICY_SHORTEN or RTTTL_LATE_POLICY_DROP to the prepared note, which is due since aLatenessMicros.
+ * MicrosOfNextAction stays on the timeline of the song, so only the tone of the late note is shortened.
+ * For RTTTL_LATE_POLICY_DROP, the notes whose whole duration has passed are skipped before.
+ */
+void shortenLateRtttlNote(struct playRtttlState *aState, uint32_t aLatenessMicros) {
+    struct rtttlPreparedNote *tNextNote = &aState->NextNote;
+    if (aState->Flags.LatePolicy == RTTTL_LATE_POLICY_DROP) {
+        while (tNextNote->ParseResult == RTTTL_PARSE_OK && aLatenessMicros >= tNextNote->Duration) {
+            aState->MicrosOfNextAction += tNextNote->Duration;
+            aLatenessMicros -= tNextNote->Duration;
+            aState->NumberOfDroppedNotes++;
+            prepareNextRtttlNote(aState);
+        }
+        if (tNextNote->ParseResult != RTTTL_PARSE_OK || aLatenessMicros <= RTTTL_LATE_NOTE_MICROS) {
+            return;
+        }
+    }
+    if (tNextNote->Frequency != 0) {
+        unsigned long tLatenessMillis = aLatenessMicros / 1000;
+        if (tNextNote->DurationOfTone > tLatenessMillis) {
+            tNextNote->DurationOfTone -= tLatenessMillis;
+        } else {
+            tNextNote->Frequency = 0; // only the gap after the tone is left
+        }
+        // DurationOfToneMicros is not changed, since MicrosOfToneEnd is computed from the scheduled start of the note
+        aState->NumberOfShortenedNotes++;
+    }
+}
+
+/*
+ * Plays the prepared note if it is due and decodes the next one.
+ * Returns false if song has ended, after stopping the output. Does not call OnComplete.
+ */
+bool RtttlPlayer::playNoteIfDue() {
+    uint32_t tMicros = micros();
+#if defined(USE_RTTTL_STATISTICS)
+    State.Statistics.NumberOfUpdates++;
+#endif
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    if (State.IsToneOn && (int32_t) (tMicros - State.MicrosOfToneEnd) >= 0) {
+        // end of tone, the gap until the next note starts
+        State.IsToneOn = false;
+        RTTTL_OUTPUT::silence(&State);
+    }
+#endif
+    // Signed difference instead of comparing the absolute values, to handle the micros() rollover
+    if ((int32_t) (tMicros - State.MicrosOfNextAction) >= 0) {
+#if defined(USE_RTTTL_STATISTICS)
+        uint32_t tScheduledMicros = State.MicrosOfNextAction;
+#endif
+        if (State.NextNote.ParseResult == RTTTL_PARSE_NO_DATA) {
+            // Data was not available at time of decode ahead, e.g. for streams, so try again now
+            prepareNextRtttlNote(&State);
+            if (State.NextNote.ParseResult == RTTTL_PARSE_NO_DATA) {
+                // MicrosOfNextAction is not changed, so we try again at next call
+                return true;
+            }
+            // The note is late, so the following notes are timed relative to now
+            State.MicrosOfNextAction = tMicros;
+        }
+
+        uint32_t tLatenessMicros = tMicros - State.MicrosOfNextAction;
+        if (tLatenessMicros > RTTTL_LATE_NOTE_MICROS && State.NextNote.ParseResult == RTTTL_PARSE_OK) {
+            if (State.Flags.LatePolicy == RTTTL_LATE_POLICY_SHIFT) {
+                // The following notes are timed relative to now, so the rest of the song is played later
+                State.MicrosOfNextAction = tMicros;
+            } else {
+                shortenLateRtttlNote(&State, tLatenessMicros);
+#if defined(USE_RTTTL_STATISTICS)
+                tScheduledMicros = State.MicrosOfNextAction; // start of the note after the dropped ones
+#endif
+                if (State.NextNote.ParseResult == RTTTL_PARSE_NO_DATA) {
+                    return true;
+                }
+            }
+        }
+
+        if (State.NextNote.ParseResult == RTTTL_PARSE_END_OF_SONG) {
+            // end song
+            stop();
+            return false;
+        }
+
+#if defined(USE_RTTTL_STATISTICS)
+        recordRtttlNoteStatistics(&State, tScheduledMicros, tMicros);
+#endif
+        /*
+         * Output the already decoded note first, then decode the next one while this one is playing
+         */
+        playPreparedRtttlNote<RTTTL_OUTPUT>(&State);
+        prepareNextRtttlNote(&State);
+    }
+    return true;
+}
+
+/*
+ * Returns true if tone is playing, false if tone has ended or stopped
+ * If setUpdateFromInterrupt(true) was called, the notes are played by updateFromInterrupt() and this is only a status query,
+ * which calls the OnComplete function at end of song, so it is not called in interrupt context.
+ */
+bool RtttlPlayer::update() {
+    if (State.Flags.IsUpdatedFromInterrupt) {
+        if (State.IsCompletionPending) {
+            State.IsCompletionPending = false;
+            if (State.OnComplete != nullptr) {
+                State.OnComplete();
+            }
+        }
+        return State.IsRunning;
+    }
+
+    if (!State.IsRunning) {
+        return false;
+    }
+    if (!playNoteIfDue()) {
+        if (State.OnComplete != nullptr) {
+            State.OnComplete();
+            return State.IsRunning; // OnComplete may have started another song
+        }
+        return false;
+    }
+    return true;
+}
+
+bool updatePlayRtttl(void) {
+    return sDefaultRtttlPlayer.update();
+}
+
+/*
+ * To be called from a periodic timer interrupt, e.g. every millisecond by Timer1.attachInterrupt() of the TimerOne library.
+ * Then the start of a note is delayed at most by the interrupt period, independent of the latency of loop().
+ * Parsing of the next note is also done here, so the song must not be read from a Stream or a callback
+ * which cannot be used in interrupt context. Do not enable TRACE, since it prints in interrupt context.
+ */
+void RtttlPlayer::updateFromInterrupt() {
+    if (State.Flags.IsUpdatedFromInterrupt && State.IsRunning && !playNoteIfDue()) {
+        State.IsCompletionPending = true;
+    }
+}
+
+void updatePlayRtttlFromInterrupt() {
+    sDefaultRtttlPlayer.updateFromInterrupt();
+}
+
+/*
+ * Must be called before start of the song and not while playing.
+ * Then update() / updatePlayRtttl() is only a status query, which can be called with any latency.
+ */
+void RtttlPlayer::setUpdateFromInterrupt(bool aUpdateFromInterrupt) {
+    State.Flags.IsUpdatedFromInterrupt = aUpdateFromInterrupt;
+}
+
+void setPlayRtttlUpdateFromInterrupt(bool aUpdateFromInterrupt) {
+    sDefaultRtttlPlayer.setUpdateFromInterrupt(aUpdateFromInterrupt);
+}
+
+/*
+ * Returns the microseconds until the start of the next note or until the end of the current tone.
+ * Returns 0 if this action is due, e.g. if a stream waits for data, or if the song is not running.
+ * With setUpdateFromInterrupt(true), interrupts are disabled while reading the state. On AVR, the interrupt flag is restored
+ * afterwards. Other platforms have no portable way to save it, so interrupts are enabled afterwards
+ * and it must not be called with interrupts disabled, e.g. from an ISR.
+ */
+uint32_t RtttlPlayer::getMicrosToNextAction() {
+    if (!State.IsRunning) {
+        return 0;
+    }
+    bool tIsUpdatedFromInterrupt = State.Flags.IsUpdatedFromInterrupt;
+#if defined(__AVR__)
+    // Restore the interrupt flag instead of enabling interrupts, since we may be called with interrupts disabled, e.g. from an ISR
+    uint8_t tOldSREG = SREG;
+#endif
+    if (tIsUpdatedFromInterrupt) {
+        noInterrupts(); // the 32 bit value may be changed by updateFromInterrupt() while reading it
+    }
+    uint32_t tMicrosOfNextAction = State.MicrosOfNextAction;
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    if (State.IsToneOn && (int32_t) (State.MicrosOfToneEnd - tMicrosOfNextAction) < 0) {
+        tMicrosOfNextAction = State.MicrosOfToneEnd;
+    }
+#endif
+    if (tIsUpdatedFromInterrupt) {
+#if defined(__AVR__)
+        SREG = tOldSREG;
+#else
+        interrupts(); // see comment above
+#endif
+    }
+    int32_t tMicrosToNextAction = (int32_t) (tMicrosOfNextAction - (uint32_t) micros());
+    return (tMicrosToNextAction > 0) ? tMicrosToNextAction : 0;
+}
+
+uint32_t getPlayRtttlMicrosToNextAction() {
+    return sDefaultRtttlPlayer.getMicrosToNextAction();
+}
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+// The millis() timer interrupt wakes up the CPU at least once per overflow period, which is 1024 us at 16 MHz
+#define RTTTL_MILLIS_TIMER_PERIOD_MICROS    (clockCyclesToMicroseconds(64 * 256))
+#endif
+/*
+ * Returns when the next action is due, so updatePlayRtttl() can be called.
+ * AVR: Sleeps in idle mode, which keeps all timers running, so tone generation and millis() continue.
+ * Any interrupt wakes up the CPU, then we sleep again if the next action is more than one millis() timer period away.
+ * The remaining time is waited with delayMicroseconds(), so the note starts in time.
+ * Other platforms: Uses delay(), which enables the RTOS to save power e.g. on ESP32, but is a busy wait on most other cores.
+ */
+void RtttlPlayer::sleepUntilNextAction() {
+#if defined(__AVR__)
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (getMicrosToNextAction() > RTTTL_MILLIS_TIMER_PERIOD_MICROS + 50) {
+        sleep_mode();
+    }
+#else
+    uint32_t tMicrosToNextAction = getMicrosToNextAction();
+    if (tMicrosToNextAction >= 1000) {
+        delay(tMicrosToNextAction / 1000);
+    }
+#endif
+    delayMicroseconds(getMicrosToNextAction());
+}
+
+void sleepUntilPlayRtttlNextAction() {
+    sDefaultRtttlPlayer.sleepUntilNextAction();
+}
+
+#if defined(USE_RTTTL_STATISTICS)
+/*
+ * Prints the statistics accumulated since boot or the last resetStatistics().
+ * If the notes are played by interrupt, the values may change while printing.
+ */
+void RtttlPlayer::printStatistics(Print *aSerial) {
+    struct rtttlStatistics *tStatistics = &State.Statistics;
+    aSerial->print(F("Notes="));
+    aSerial->print(tStatistics->NumberOfNotes);
+    aSerial->print(F(" updates="));
+    aSerial->print(tStatistics->NumberOfUpdates);
+    aSerial->print(F(" loop restarts="));
+    aSerial->print(tStatistics->NumberOfLoopRestarts);
+    aSerial->print(F(" late notes="));
+    aSerial->println(tStatistics->NumberOfLateNotes);
+    if (tStatistics->NumberOfNotes == 0) {
+        return;
+    }
+    aSerial->print(F("Lateness mean="));
+    aSerial->print(tStatistics->SumOfLatenessMicros / tStatistics->NumberOfNotes);
+    aSerial->print(F(" max="));
+    aSerial->print(tStatistics->MaximumLatenessMicros);
+    aSerial->println(F(" us"));
+
+    uint32_t tBinLimit = RTTTL_LATENESS_HISTOGRAM_FIRST_BIN_MICROS;
+    for (uint_fast8_t i = 0; i < RTTTL_LATENESS_HISTOGRAM_BINS; ++i) {
+        if (i < RTTTL_LATENESS_HISTOGRAM_BINS - 1) {
+            aSerial->print(F(" < "));
+            aSerial->print(tBinLimit);
+        } else {
+            aSerial->print(F(">= "));
+            aSerial->print(tBinLimit >> 1);
+        }
+        aSerial->print(F(" us: "));
+        aSerial->println(tStatistics->LatenessHistogram[i]);
+        tBinLimit <<= 1;
+    }
+
+    /*
+     * The last notes, oldest first
+     */
+    uint8_t tNumberOfRecords = RTTTL_STATISTICS_NUMBER_OF_RECORDS;
+    if (tStatistics->NumberOfNotes < RTTTL_STATISTICS_NUMBER_OF_RECORDS) {
+        tNumberOfRecords = tStatistics->NumberOfNotes;
+    }
+    aSerial->println(F("Scheduled us, lateness us, Hz, duration us"));
+    uint8_t tIndex = tStatistics->IndexOfNextRecord - tNumberOfRecords;
+    for (uint_fast8_t i = 0; i < tNumberOfRecords; ++i) {
+        struct rtttlNoteRecord *tRecord = &tStatistics->Records[tIndex & (RTTTL_STATISTICS_NUMBER_OF_RECORDS - 1)];
+        aSerial->print(tRecord->ScheduledMicros);
+        aSerial->print(F(", "));
+        aSerial->print(tRecord->ActualMicros - tRecord->ScheduledMicros);
+        aSerial->print(F(", "));
+        aSerial->print(tRecord->Frequency);
+        aSerial->print(F(", "));
+        aSerial->println(tRecord->Duration);
+        tIndex++;
+    }
+}
+
+void printPlayRtttlStatistics(Print *aSerial) {
+    sDefaultRtttlPlayer.printStatistics(aSerial);
+}
+
+void RtttlPlayer::resetStatistics() {
+    memset(&State.Statistics, 0, sizeof(State.Statistics));
+}
+
+void resetPlayRtttlStatistics() {
+    sDefaultRtttlPlayer.resetStatistics();
+}
+#endif
+
+void getRtttlName(const char *aRTTTLArrayPtr, char *aBuffer, uint8_t aBuffersize) {
+    char tChar = *aRTTTLArrayPtr++;
+    while (tChar != ':' && aBuffersize > 1) {
+        *aBuffer++ = tChar;
+        aBuffersize--;
+        tChar = *aRTTTLArrayPtr++;
+    }
+    *aBuffer = '\0';
+}
+
+/*
+ * Prints text "Now playing: Song xy"
+ * call it e.g. printNamePGM(RTTTLMelodies[tRandomIndex], &Serial);
+ */
+void printName(const char *aRTTTLArrayPtr, Print *aSerial) {
+    char tStringBuffer[16];
+    aSerial->print(F("Now playing: "));
+    getRtttlName(aRTTTLArrayPtr, tStringBuffer, sizeof(tStringBuffer));
+    aSerial->println(tStringBuffer);
+}
+
+/*
+ * Plays one of the songs in the array specified non blocking. Ie. you must call updatePlayRtttl() in your loop or use the callback function.
+ * aNumberOfEntriesInSongArrayPGM is (sizeof(<MyArrayName>) / sizeof(char *) - 1)
+ * char tStringBuffer[16] is sufficient for most titles.
+ */
+void startPlayRandomRtttlFromArray(uint8_t aTonePin, const char *const aSongArray[], uint8_t aNumberOfEntriesInSongArray,
+        char *aBufferPointer, uint8_t aBufferSize, void (*aOnComplete)()) {
+    uint8_t tRandomIndex = random(0, aNumberOfEntriesInSongArray - 1);
+    char *tSongPtr = (char*) aSongArray[tRandomIndex];
+    startPlayRtttl(aTonePin, tSongPtr, aOnComplete);
+    if (aBufferPointer != nullptr) {
+// copy title to buffer
+        getRtttlName(tSongPtr, aBufferPointer, aBufferSize);
+    }
+}
+
+void startPlayRandomRtttlFromArrayAndPrintName(uint8_t aTonePin, const char *const aSongArray[],
+        uint8_t aNumberOfEntriesInSongArray, Print *aSerial, void (*aOnComplete)()) {
+    uint8_t tRandomIndex = random(0, aNumberOfEntriesInSongArray - 1);
+    char *tSongPtr = (char*) aSongArray[tRandomIndex];
+    startPlayRtttl(aTonePin, tSongPtr, aOnComplete);
+// print title
+    printName(tSongPtr, aSerial);
+}
+
+/*
+ * Plays one of the samples from RTTTLMelodies array
+ */
+void playRandomRtttlSampleBlocking(uint8_t aTonePin) {
+    uint8_t tRandomIndex = random(0, sizeof(RTTTLMelodies) / sizeof(char*) - 1);
+    char *tSongPtr = (char*) RTTTLMelodies[tRandomIndex];
+    playRtttlBlocking(aTonePin, tSongPtr);
+}
+
+void playRandomRtttlSampleBlockingAndPrintName(uint8_t aTonePin, Print *aSerial) {
+    uint8_t tRandomIndex = random(0, sizeof(RTTTLMelodies) / sizeof(char*) - 1);
+    char *tSongPtr = (char*) RTTTLMelodies[tRandomIndex];
+    printName(tSongPtr, aSerial);
+    playRtttlBlocking(aTonePin, tSongPtr);
+}
+
+void playRtttlBlockingPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM) {
+    startPlayRtttlPGM(aTonePin, aRTTTLArrayPtrPGM, nullptr);
+    while (updatePlayRtttl()) {
+        delay(1); // this in turn calls yield();
+    }
+}
+
+void playRtttlBlockingLowPowerPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM) {
+    startPlayRtttlPGM(aTonePin, aRTTTLArrayPtrPGM, nullptr);
+    while (updatePlayRtttl()) {
+        sleepUntilPlayRtttlNextAction();
+    }
+}
+
+/**
+ * @param  aRTTTLArrayPtrPGM a pointer to an PGM array of pointers to PGM song data
+ */
+void startPlayRtttlPGMPGM(uint8_t aTonePin, const char *const*aRTTTLPGMArrayPtrPGM, void (*aOnComplete)()) {
+#if defined(__AVR__)
+    const char *tRTTTLPGMArrayPtrPGM = (const char*) pgm_read_word(aRTTTLPGMArrayPtrPGM);
+#else
+    const char *tRTTTLPGMArrayPtrPGM = *aRTTTLPGMArrayPtrPGM;
+#endif
+    startPlayRtttlPGM(aTonePin, tRTTTLPGMArrayPtrPGM, aOnComplete);
+}
+
+/*
+ * Non blocking version for RTTTL Data in FLASH. Ie. you must call update() in your loop.
+ * @param  aRTTTLArrayPtrPGM a pointer to PGM song data
+ */
+void RtttlPlayer::startPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM, void (*aOnComplete)()) {
+    startFromSource<RtttlSourcePGM>(aTonePin, (rtttlAddress_t) aRTTTLArrayPtrPGM, true, aOnComplete);
+}
+
+void startPlayRtttlPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startPGM(aTonePin, aRTTTLArrayPtrPGM, aOnComplete);
+}
+
+/*
+ * Version for RTTTL Data in FLASH above 64k, e.g. on ATmega2560.
+ * @param  aRTTTLArrayAddressFarPGM the address of the song data as returned by pgm_get_far_address()
+ */
+void RtttlPlayer::startFarPGM(uint8_t aTonePin, rtttlAddress_t aRTTTLArrayAddressFarPGM, void (*aOnComplete)()) {
+    startFromSource<RtttlSourceFarPGM>(aTonePin, aRTTTLArrayAddressFarPGM, true, aOnComplete);
+}
+
+void startPlayRtttlFarPGM(uint8_t aTonePin, rtttlAddress_t aRTTTLArrayAddressFarPGM, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startFarPGM(aTonePin, aRTTTLArrayAddressFarPGM, aOnComplete);
+}
+
+#if defined(__AVR__)
+/*
+ * Version for RTTTL Data in EEPROM, e.g. declared with EEMEM.
+ */
+void RtttlPlayer::startEEPROM(uint8_t aTonePin, const char *aRTTTLArrayPtrEEPROM, void (*aOnComplete)()) {
+    startFromSource<RtttlSourceEEPROM>(aTonePin, (rtttlAddress_t) aRTTTLArrayPtrEEPROM, false, aOnComplete);
+}
+
+void startPlayRtttlEEPROM(uint8_t aTonePin, const char *aRTTTLArrayPtrEEPROM, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startEEPROM(aTonePin, aRTTTLArrayPtrEEPROM, aOnComplete);
+}
+#endif
 
 /*
- * Blocking versions
+ * Version for RTTTL data read by a user function, e.g. from an external SPI FLASH or a SD card.
+ * @param aReadCharFunction returns the character at aAddress, aAddress is incremented by 1 for each character
  */
-void playRtttlBlocking(uint8_t aTonePin, const char *aRTTTLArrayPtr) {
-    startPlayRtttl(aTonePin, aRTTTLArrayPtr, nullptr);
-    while (updatePlayRtttl()) {
-        delay(1); // this in turn calls yield();
+void RtttlPlayer::startFromCallback(uint8_t aTonePin, char (*aReadCharFunction)(rtttlAddress_t aAddress),
+        rtttlAddress_t aStartAddress, void (*aOnComplete)()) {
+    State.ReadCharFunction = aReadCharFunction;
+    startFromSource<RtttlSourceCallback>(aTonePin, aStartAddress, false, aOnComplete);
+}
+
+void startPlayRtttlFromCallback(uint8_t aTonePin, char (*aReadCharFunction)(rtttlAddress_t aAddress), rtttlAddress_t aStartAddress,
+        void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startFromCallback(aTonePin, aReadCharFunction, aStartAddress, aOnComplete);
+}
+
+// The read and write addresses are wrapped by masking
+static_assert(RTTTL_STREAM_BUFFER_SIZE != 0 && (RTTTL_STREAM_BUFFER_SIZE & (RTTTL_STREAM_BUFFER_SIZE - 1)) == 0,
+        "RTTTL_STREAM_BUFFER_SIZE must be a power of 2");
+struct rtttlStreamBuffer sRtttlStreamBuffer;
+
+struct RtttlSourceStream {
+    static char readChar(struct playRtttlState *aState, rtttlAddress_t aAddress) {
+        return aState->StreamBuffer->Buffer[aAddress & (RTTTL_STREAM_BUFFER_SIZE - 1)];
     }
+};
+
+bool isEndOfStreamCharacter(char aChar) {
+    return aChar == '\0' || aChar == '\n' || aChar == '\r';
 }
 
+#define RTTTL_STREAM_NOT_FOUND      0
+#define RTTTL_STREAM_FOUND          1
+#define RTTTL_STREAM_FOUND_END      2
 /*
- * Version for RTTTL Data in RAM. Ie. you must call updatePlayRtttl() in your loop.
- * Since we do not need all the pgm_read_byte() calls this version is more simple and maybe better to understand.
+ * Searches aCharacter or an end character in the ring buffer between aStartAddress and WriteAddress
  */
-void startPlayRtttl(uint8_t aTonePin, const char *aRTTTLArrayPtr, void (*aOnComplete)()) {
-    sPlayRtttlState.Flags.IsPGMMemory = false;
-    sPlayRtttlState.OnComplete = aOnComplete;
-    sPlayRtttlState.TonePin = aTonePin;
-    int tNumber;
-    /*
-     * Skip name and :
-     */
-#if defined(LOCAL_DEBUG)
-    sPointerToSerial->print(F("Title="));
-#endif
-    while (*aRTTTLArrayPtr != ':') {
-        /*
-         * Read title
-         */
-#if defined(LOCAL_DEBUG)
-        sPointerToSerial->print(*aRTTTLArrayPtr);
-#endif
-        aRTTTLArrayPtr++;
+uint8_t searchInStreamBuffer(struct playRtttlState *aState, rtttlAddress_t aStartAddress, char aCharacter) {
+    for (rtttlAddress_t tAddress = aStartAddress; tAddress != aState->StreamBuffer->WriteAddress; tAddress++) {
+        char tChar = RtttlSourceStream::readChar(aState, tAddress);
+        if (tChar == aCharacter) {
+            return RTTTL_STREAM_FOUND;
+        }
+        if (isEndOfStreamCharacter(tChar)) {
+            return RTTTL_STREAM_FOUND_END;
+        }
     }
+    return RTTTL_STREAM_NOT_FOUND;
+}
 
-    sPlayRtttlState.DefaultDuration = DEFAULT_DURATION;
-    sPlayRtttlState.DefaultOctave = DEFAULT_OCTAVE;
-    sPlayRtttlState.TimeForWholeNoteMillis = (60 * 1000L / DEFAULT_BPM) * 4;
-#if !defined(USE_NO_RTX_EXTENSIONS)
-    sPlayRtttlState.NumberOfLoops = 1;
-    sPlayRtttlState.StyleDivisorValue = sDefaultStyleDivisorValue;
-#endif
-
-#if !defined(USE_NO_RTX_EXTENSIONS)
-#if defined(LOCAL_DEBUG)
-    char tStyleChar = RTX_STYLE_DEFAULT;
-#else
-    char tStyleChar;
-#endif
-#endif
-    int tBPM = 0;
-
-    do {
-        /*
-         * Get character after separator (comma or colon)
-         */
-        aRTTTLArrayPtr++;
+/*
+ * The function stored in ParseNextNote for streaming.
+ * Copies the available characters into the ring buffer and parses the note, if it is completely received.
+ * Before, the name is skipped and the header is parsed as soon as it is completely received.
+ * @return RTTTL_PARSE_OK, RTTTL_PARSE_END_OF_SONG or RTTTL_PARSE_NO_DATA
+ */
+uint8_t parseNextRtttlNoteFromStream(struct playRtttlState *aState, struct rtttlNote *aNote) {
+    struct rtttlStreamBuffer *tBuffer = aState->StreamBuffer;
 
-        /*
-         * Read song info with format: d=N(N),o=N,b=NNN:
-         */
-        if (*aRTTTLArrayPtr == 'd') {
-            /*
-             * get default duration
-             */
-            aRTTTLArrayPtr++;
-            aRTTTLArrayPtr++;              // skip "d="
-            tNumber = 0;
-            while (isdigit(*aRTTTLArrayPtr)) {
-                tNumber = (tNumber * 10) + (*aRTTTLArrayPtr++ - '0');
-            }
-            if (tNumber == 0) {
-                tNumber = DEFAULT_DURATION;
+    /*
+     * Fill ring buffer
+     */
+    while ((rtttlAddress_t) (tBuffer->WriteAddress - aState->NextTonePointer) < RTTTL_STREAM_BUFFER_SIZE
+            && tBuffer->StreamPtr->available() > 0) {
+        char tChar = tBuffer->StreamPtr->read();
+        if (tBuffer->Phase == RTTTL_STREAM_READ_NAME) {
+            // The name is not stored, so it may be longer than the buffer
+            if (tChar != ':') {
+                continue;
             }
-            sPlayRtttlState.DefaultDuration = tNumber;
+            tBuffer->Phase = RTTTL_STREAM_READ_HEADER;
         }
+        tBuffer->Buffer[tBuffer->WriteAddress & (RTTTL_STREAM_BUFFER_SIZE - 1)] = tChar;
+        tBuffer->WriteAddress++;
+    }
+    bool tIsBufferFull = ((rtttlAddress_t) (tBuffer->WriteAddress - aState->NextTonePointer) >= RTTTL_STREAM_BUFFER_SIZE);
 
+    if (tBuffer->Phase != RTTTL_STREAM_READ_NOTES) {
         /*
-         * get default octave
+         * Wait for the colon at the end of the header. The colon after the name is at NextTonePointer.
          */
-        else if (*aRTTTLArrayPtr == 'o') {
-            aRTTTLArrayPtr++;
-            aRTTTLArrayPtr++;              // skip "o="
-            tNumber = *aRTTTLArrayPtr++ - '0';
-            if (tNumber < 3 && tNumber > 7) {
-                tNumber = DEFAULT_OCTAVE;
+        if (tBuffer->Phase == RTTTL_STREAM_READ_HEADER) {
+            uint8_t tSearchResult = searchInStreamBuffer(aState, aState->NextTonePointer + 1, ':');
+            if (tSearchResult == RTTTL_STREAM_FOUND_END) {
+                return RTTTL_PARSE_END_OF_SONG; // Invalid header
             }
-            sPlayRtttlState.DefaultOctave = tNumber;
-        }
-
+            if (tSearchResult == RTTTL_STREAM_FOUND) {
+                aState->NextTonePointer = parseRtttlHeader<RtttlSourceStream>(aState, aState->NextTonePointer);
 #if !defined(USE_NO_RTX_EXTENSIONS)
-        else if (*aRTTTLArrayPtr == 's') {
-            // get Style
-            aRTTTLArrayPtr++;
-            aRTTTLArrayPtr++;           // skip "s="
-            tStyleChar = *aRTTTLArrayPtr++;
-            tNumber = convertStyleCharacterToDivisorValue(tStyleChar);
-            sPlayRtttlState.StyleDivisorValue = tNumber;
-        }
-
-        // get loops
-        else if (*aRTTTLArrayPtr == 'l') {
-            tNumber = 0;
-            aRTTTLArrayPtr++;
-            aRTTTLArrayPtr++;              // skip "l="
-            while (isdigit(*aRTTTLArrayPtr)) {
-                tNumber = (tNumber * 10) + (*aRTTTLArrayPtr++ - '0');
-            }
-            if (tNumber == 15) {
-                tNumber = 0;
-            }
-            sPlayRtttlState.NumberOfLoops = tNumber;
-        }
+                aState->NumberOfLoops = 1; // we cannot repeat a stream
 #endif
-
-        else if (*aRTTTLArrayPtr == 'b') {
-            // get BPM
-            aRTTTLArrayPtr++;
-            aRTTTLArrayPtr++;              // skip "b="
-//            tBPM = 0;
-            while (isdigit(*aRTTTLArrayPtr)) {
-                tBPM = (tBPM * 10) + (*aRTTTLArrayPtr++ - '0');
-            }
-            if (tBPM == 0) {
-                tBPM = DEFAULT_BPM;
+                tBuffer->Phase = RTTTL_STREAM_READ_NOTES;
+                return parseNextRtttlNoteFromStream(aState, aNote);
             }
-            // BPM usually expresses the number of quarter notes per minute
-            sPlayRtttlState.TimeForWholeNoteMillis = (60 * 1000L / tBPM) * 4;
         }
+        if (tIsBufferFull) {
+            return RTTTL_PARSE_END_OF_SONG; // Header does not fit into buffer
+        }
+        return RTTTL_PARSE_NO_DATA;
+    }
 
-    } while (*aRTTTLArrayPtr != ':');
-
-    aRTTTLArrayPtr++; // skip colon
-
-#if defined(LOCAL_DEBUG)
-    sPointerToSerial->print(F(" DefaultDuration="));
-    sPointerToSerial->print(sPlayRtttlState.DefaultDuration);
-    sPointerToSerial->print(F(" DefaultOctave="));
-    sPointerToSerial->print(sPlayRtttlState.DefaultOctave);
-    sPointerToSerial->print(F(" BPM="));
-    sPointerToSerial->print(tBPM);
-#  if !defined(USE_NO_RTX_EXTENSIONS)
-    sPointerToSerial->print(F(" Style="));
-    sPointerToSerial->print(tStyleChar);
-    if (sPlayRtttlState.StyleDivisorValue != 0) {
-        sPointerToSerial->print(F(" -> 1/"));
-        sPointerToSerial->print(sPlayRtttlState.StyleDivisorValue);
-        sPointerToSerial->print(F(" pause between notes,"));
+    if (tBuffer->WriteAddress != aState->NextTonePointer
+            && isEndOfStreamCharacter(RtttlSourceStream::readChar(aState, aState->NextTonePointer))) {
+        return RTTTL_PARSE_END_OF_SONG;
     }
-    sPointerToSerial->print(F(" Loops="));
-    sPointerToSerial->print(sPlayRtttlState.NumberOfLoops);
-#  endif
-    sPointerToSerial->println();
-#endif
+    if (searchInStreamBuffer(aState, aState->NextTonePointer, ',') == RTTTL_STREAM_NOT_FOUND) {
+        if (tIsBufferFull) {
+            return RTTTL_PARSE_END_OF_SONG; // No valid note in buffer
+        }
+        /*
+         * Called ahead of time by prepareNextRtttlNote(), so it is only an underrun if the note is already due
+         */
+        if (!tBuffer->IsInUnderrun && (int32_t) ((uint32_t) micros() - aState->MicrosOfNextAction) >= 0) {
+            tBuffer->IsInUnderrun = true;
+            tBuffer->NumberOfUnderruns++;
+        }
+        return RTTTL_PARSE_NO_DATA;
+    }
+    tBuffer->IsInUnderrun = false;
+    aState->NextTonePointer = parseRtttlNote<RtttlSourceStream>(aState, aState->NextTonePointer, aNote);
+    return RTTTL_PARSE_OK;
+}
 
-    sPlayRtttlState.MillisOfNextAction = 0;
-    sPlayRtttlState.NextTonePointer = aRTTTLArrayPtr;
-#if !defined(USE_NO_RTX_EXTENSIONS)
-    sPlayRtttlState.LastTonePointer = aRTTTLArrayPtr;
-#endif
-    sPlayRtttlState.Flags.IsRunning = true;
+/*
+ * Non blocking version for RTTTL data received by a Stream like Serial. Ie. you must call update() in your loop.
+ * Only the RTTTL_STREAM_BUFFER_SIZE bytes of aStreamBuffer are used, independent of the song length.
+ * If the data of a note is not received when the note is due, the note is played as soon as it is received
+ * and the underrun is counted, see getStreamUnderruns().
+ */
+void RtttlPlayer::startFromStream(uint8_t aTonePin, Stream *aStream, struct rtttlStreamBuffer *aStreamBuffer,
+        void (*aOnComplete)()) {
+    aStreamBuffer->StreamPtr = aStream;
+    aStreamBuffer->WriteAddress = 0;
+    aStreamBuffer->NumberOfUnderruns = 0;
+    aStreamBuffer->Phase = RTTTL_STREAM_READ_NAME;
+    aStreamBuffer->IsInUnderrun = false;
+
+    State.IsRunning = false; // keep updateFromInterrupt() off the state until it is set up
+    State.StreamBuffer = aStreamBuffer;
+    State.Flags.IsPGMMemory = false;
+    State.Flags.IsCompiled = false;
+    State.ParseNextNote = &parseNextRtttlNoteFromStream;
+    State.OnComplete = aOnComplete;
+    State.TonePin = aTonePin;
+    setRtttlHeaderDefaults(&State);
+    startAtFirstNote(0);
+}
 
-    /*
-     * Play first tone
-     */
-    updatePlayRtttl();
+uint16_t RtttlPlayer::getStreamUnderruns() {
+    return State.StreamBuffer->NumberOfUnderruns;
 }
 
-bool isPlayRtttlRunning() {
-    return sPlayRtttlState.Flags.IsRunning;
+void startPlayRtttlFromStream(uint8_t aTonePin, Stream *aStream, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startFromStream(aTonePin, aStream, &sRtttlStreamBuffer, aOnComplete);
 }
 
-#if !defined(ESP_ARDUINO_VERSION)
-#define ESP_ARDUINO_VERSION 0x010101 // Version 1.1.1
-#endif
-#if !defined(ESP_ARDUINO_VERSION_VAL)
-#define ESP_ARDUINO_VERSION_VAL(major, minor, patch) ((major << 16) | (minor << 8) | (patch))
-#endif
-void stopPlayRtttl(void) {
-#if defined(ESP32) && ESP_ARDUINO_VERSION  <= ESP_ARDUINO_VERSION_VAL(2, 0, 2)
-    ledcWriteTone(sPlayRtttlState.TonePin, 0);
-#else
-    noTone(sPlayRtttlState.TonePin);
-#  if defined(TCCR2A)
-    // reset direct hardware toggle output at OC2A / pin 11
-    TCCR2A &= ~_BV(COM2A0);
-#  endif
-#endif
-    // noTone sets pin to LOW ->  need to handle inverted pin mode here
-    if (sPlayRtttlState.Flags.IsTonePinInverted) {
-        digitalWrite(sPlayRtttlState.TonePin, HIGH);
-    }
-    sPlayRtttlState.Flags.IsRunning = false;
+uint16_t getPlayRtttlStreamUnderruns() {
+    return sRtttlStreamBuffer.NumberOfUnderruns;
 }
 
-char getNextCharFromRTTLArray(const char *aRTTTLArrayPtr) {
-    if (sPlayRtttlState.Flags.IsPGMMemory) {
-        return pgm_read_byte(aRTTTLArrayPtr);
+/*
+ * Reads the header of compiled data and plays first note.
+ * aIsPGMMemory is required for reading the header here.
+ */
+void RtttlPlayer::startCompiledInternal(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, bool aIsPGMMemory,
+        void (*aOnComplete)()) {
+    State.IsRunning = false; // keep updateFromInterrupt() off the state until it is set up
+    State.Flags.IsPGMMemory = aIsPGMMemory;
+    State.Flags.IsCompiled = true;
+    State.OnComplete = aOnComplete;
+    State.TonePin = aTonePin;
+
+    State.BeatsPerMinute = getNextWordFromCompiledArray(&State, aCompiledArrayPtr);
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    uint16_t tLoopsAndStyle = getNextWordFromCompiledArray(&State, aCompiledArrayPtr + 1);
+    State.NumberOfLoops = tLoopsAndStyle >> 8;
+    uint8_t tStyleDivisorValue = tLoopsAndStyle & 0xFF;
+    if (tStyleDivisorValue == RTTTL_COMPILED_STYLE_DEFAULT) {
+        tStyleDivisorValue = sDefaultStyleDivisorValue;
     }
-    return *aRTTTLArrayPtr;
+    State.StyleDivisorValue = tStyleDivisorValue;
+#endif
+    initRtttlDurations(&State);
+    startAtFirstNote((rtttlAddress_t) (aCompiledArrayPtr + RTTTL_COMPILED_HEADER_SIZE));
 }
 
 /*
- * Returns true if tone is playing, false if tone has ended or stopped
+ * Non blocking version for compiled data in RAM, e.g. generated by convertRtttlToCompiled().
+ * Ie. you must call update() in your loop.
  */
-bool updatePlayRtttl(void) {
-
-    if (!sPlayRtttlState.Flags.IsRunning) {
-        return false;
-    }
+void RtttlPlayer::startCompiled(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, void (*aOnComplete)()) {
+    startCompiledInternal(aTonePin, aCompiledArrayPtr, false, aOnComplete);
+}
 
-#if defined(TRACE)
-    bool isSharp = false;
-    char tNoteCharUppercase;
-#endif
+void startPlayRtttlCompiled(uint8_t aTonePin, const uint16_t *aCompiledArrayPtr, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startCompiled(aTonePin, aCompiledArrayPtr, aOnComplete);
+}
 
-    long tMillis = millis();
-    if (tMillis >= sPlayRtttlState.MillisOfNextAction) {
-        const char *tRTTTLArrayPtr = sPlayRtttlState.NextTonePointer;
+/*
+ * Non blocking version for compiled data in FLASH. Ie. you must call update() in your loop.
+ */
+void RtttlPlayer::startCompiledPGM(uint8_t aTonePin, const uint16_t *aCompiledArrayPtrPGM, void (*aOnComplete)()) {
+    startCompiledInternal(aTonePin, aCompiledArrayPtrPGM, true, aOnComplete);
+}
 
-        char tChar;
-        tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
+void startPlayRtttlCompiledPGM(uint8_t aTonePin, const uint16_t *aCompiledArrayPtrPGM, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startCompiledPGM(aTonePin, aCompiledArrayPtrPGM, aOnComplete);
+}
 
-        /*
-         * Check if end of string reached
-         */
-        if (tChar == '\0') {
-#if !defined(USE_NO_RTX_EXTENSIONS)
-            uint8_t tNumberOfLoops = sPlayRtttlState.NumberOfLoops;
-            if (tNumberOfLoops > 1) {
-                sPlayRtttlState.NumberOfLoops--;
-            }
-            if (tNumberOfLoops == 1) {
-#endif
-                // end song
-                stopPlayRtttl();
-                if (sPlayRtttlState.OnComplete != nullptr) {
-                    sPlayRtttlState.OnComplete();
-                }
-                return false;
-#if !defined(USE_NO_RTX_EXTENSIONS)
-            } else {
-                // loop again
-#  if defined(LOCAL_DEBUG)
-                sPointerToSerial->print(F("Loop count="));
-                sPointerToSerial->println(sPlayRtttlState.NumberOfLoops);
-#  endif
-                sPlayRtttlState.MillisOfNextAction = 0;
-                sPlayRtttlState.NextTonePointer = sPlayRtttlState.LastTonePointer;
-                return updatePlayRtttl();
-            }
-#endif // USE_NO_RTX_EXTENSIONS
-        }
+uint8_t readRtttlPackedNibble(const uint8_t *aBankPGM, uint16_t aNibbleIndex) {
+    uint8_t tByte = pgm_read_byte(aBankPGM + (aNibbleIndex >> 1));
+    if (aNibbleIndex & 1) {
+        return tByte & 0x0F;
+    }
+    return tByte >> 4;
+}
 
-        uint8_t tDurationNumber;
-        unsigned long tDuration;
-        uint8_t tNote;
-        uint8_t tOctave;
+uint16_t readRtttlPackedWord(const uint8_t *aBankPGM, uint16_t aByteIndex) {
+    return pgm_read_byte(aBankPGM + aByteIndex) | (pgm_read_byte(aBankPGM + aByteIndex + 1) << 8);
+}
 
-// first, get note duration, if available
-        tDurationNumber = 0;
-        while (isdigit(tChar)) {
-            tDurationNumber = (tDurationNumber * 10) + (tChar - '0');
-            tRTTTLArrayPtr++;
-            tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
+/*
+ * Returns the next nibble of the song at NextTonePointer and inserts the phrases transparently.
+ * Phrases contain no RTTTL_PACKED_ESCAPE, so they cannot be nested.
+ * @return RTTTL_PACKED_END at end of song
+ */
+uint8_t readNextRtttlPackedNibble(struct playRtttlState *aState) {
+    struct rtttlPackedDecoder *tDecoder = &aState->Packed;
+    if (aState->NextTonePointer == tDecoder->PhraseEnd) {
+        aState->NextTonePointer = tDecoder->PhraseReturn;
+        tDecoder->PhraseEnd = 0;
+    }
+    uint8_t tNibble = readRtttlPackedNibble(tDecoder->BankPGM, aState->NextTonePointer++);
+    if (tNibble == RTTTL_PACKED_ESCAPE) {
+        uint8_t tPhraseIndex = (readRtttlPackedNibble(tDecoder->BankPGM, aState->NextTonePointer) << 4)
+                | readRtttlPackedNibble(tDecoder->BankPGM, aState->NextTonePointer + 1);
+        if (tPhraseIndex == RTTTL_PACKED_END) {
+            aState->NextTonePointer--; // stay at end of song
+            return RTTTL_PACKED_END;
         }
+        uint16_t tPhraseTableIndex = 2 + 2 * (pgm_read_byte(tDecoder->BankPGM) + tPhraseIndex);
+        tDecoder->PhraseReturn = aState->NextTonePointer + 2;
+        tDecoder->PhraseEnd = readRtttlPackedWord(tDecoder->BankPGM, tPhraseTableIndex + 2);
+        aState->NextTonePointer = readRtttlPackedWord(tDecoder->BankPGM, tPhraseTableIndex);
+        tNibble = readRtttlPackedNibble(tDecoder->BankPGM, aState->NextTonePointer++);
+    }
+    return tNibble;
+}
 
-        if (tDurationNumber == 0) {
-            tDurationNumber = sPlayRtttlState.DefaultDuration; // we will need to check if we are a dotted note after
+/*
+ * The function stored in ParseNextNote for packed songs.
+ * The current duration and octave are stored in DefaultDuration and DefaultOctave, which are not used otherwise.
+ */
+uint8_t parseNextRtttlNoteFromPacked(struct playRtttlState *aState, struct rtttlNote *aNote) {
+    uint8_t tNibble = readNextRtttlPackedNibble(aState);
+    while (tNibble == RTTTL_PACKED_DURATION || tNibble == RTTTL_PACKED_OCTAVE) {
+        uint8_t tValue = readNextRtttlPackedNibble(aState);
+        if (tNibble == RTTTL_PACKED_DURATION) {
+            aState->DefaultDuration = tValue;
+        } else {
+            aState->DefaultOctave = tValue;
         }
-        tDuration = sPlayRtttlState.TimeForWholeNoteMillis / tDurationNumber;
+        tNibble = readNextRtttlPackedNibble(aState);
+    }
+    if (tNibble == RTTTL_PACKED_END) {
+        return RTTTL_PARSE_END_OF_SONG;
+    }
+    if (tNibble == RTTTL_PACKED_PAUSE) {
+        tNibble = RTTTL_COMPILED_PAUSE; // 12 would be b#
+    }
+    aNote->Note = tNibble;
+    aNote->Octave = aState->DefaultOctave;
+    aNote->DurationNumber = 1 << (aState->DefaultDuration & ~RTTTL_PACKED_DOT);
+    aNote->NumberOfDots = aState->DefaultDuration / RTTTL_PACKED_DOT;
+    return RTTTL_PARSE_OK;
+}
 
-// now get the note
-        tNote = 42; // Pause
-#if defined(TRACE)
-        tNoteCharUppercase = tChar - 0x20;
-#endif
+uint8_t getRtttlPackedNumberOfSongsPGM(const uint8_t *aPackedBankPGM) {
+    return pgm_read_byte(aPackedBankPGM);
+}
 
-        switch (tChar) {
-        case 'c':
-            tNote = 0;
-            break;
-        case 'd':
-            tNote = 2;
-            break;
-        case 'e':
-            tNote = 4;
-            break;
-        case 'f':
-            tNote = 5;
-            break;
-        case 'g':
-            tNote = 7;
-            break;
-        case 'a':
-            tNote = 9;
-            break;
-        case 'b':
-        case 'h':  // I have seen this
-            tNote = 11;
-            break;
-        case 'p':
-        default:
-#if defined(TRACE)
-            tNoteCharUppercase = 'P';
+/*
+ * Non blocking version for a song of a packed bank in FLASH, e.g. RTTTLMelodiesPacked of PlayRtttlPackedMelodies.h.
+ * Ie. you must call update() in your loop. Nothing is played if aSongIndex is not less than the number of songs of the bank.
+ */
+void RtttlPlayer::startPackedPGM(uint8_t aTonePin, const uint8_t *aPackedBankPGM, uint8_t aSongIndex, void (*aOnComplete)()) {
+    if (aSongIndex >= getRtttlPackedNumberOfSongsPGM(aPackedBankPGM)) {
+        stop();
+        return;
+    }
+    State.IsRunning = false; // keep updateFromInterrupt() off the state until it is set up
+    State.Flags.IsPGMMemory = true;
+    State.Flags.IsCompiled = false;
+    State.ParseNextNote = &parseNextRtttlNoteFromPacked;
+    State.Packed.BankPGM = aPackedBankPGM;
+    State.Packed.PhraseEnd = 0;
+    State.OnComplete = aOnComplete;
+    State.TonePin = aTonePin;
+
+    uint16_t tNibbleIndex = readRtttlPackedWord(aPackedBankPGM, 2 + 2 * aSongIndex);
+    uint16_t tBeatsPerMinute = 0;
+    for (uint8_t i = 0; i < 3; ++i) {
+        tBeatsPerMinute = (tBeatsPerMinute << 4) | readRtttlPackedNibble(aPackedBankPGM, tNibbleIndex++);
+    }
+    State.BeatsPerMinute = tBeatsPerMinute;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    State.NumberOfLoops = readRtttlPackedNibble(aPackedBankPGM, tNibbleIndex);
+    uint8_t tStyleDivisorValue = (readRtttlPackedNibble(aPackedBankPGM, tNibbleIndex + 1) << 4)
+            | readRtttlPackedNibble(aPackedBankPGM, tNibbleIndex + 2);
+    if (tStyleDivisorValue == RTTTL_COMPILED_STYLE_DEFAULT) {
+        tStyleDivisorValue = sDefaultStyleDivisorValue;
+    }
+    State.StyleDivisorValue = tStyleDivisorValue;
 #endif
-            tNote = 42; // pause
-        }
+    tNibbleIndex += RTTTL_PACKED_SONG_HEADER_NIBBLES - 3;
+    initRtttlDurations(&State);
+    startAtFirstNote(tNibbleIndex);
+}
 
-        tRTTTLArrayPtr++;
-        tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
+void startPlayRtttlPackedPGM(uint8_t aTonePin, const uint8_t *aPackedBankPGM, uint8_t aSongIndex, void (*aOnComplete)()) {
+    sDefaultRtttlPlayer.startPackedPGM(aTonePin, aPackedBankPGM, aSongIndex, aOnComplete);
+}
 
-        // now, get optional '#' sharp (or '_' as seen on many songs)
-        if (tChar == '#' || tChar == '_') {
-#if defined(TRACE)
-            isSharp = true;
+/*
+ * Converts the notes of the RTTTL text, the header values must already be parsed into aState.
+ * @return number of words written or 0 if buffer is too small or song contains a duration which is not a power of 2
+ */
+template<typename Source>
+uint16_t convertRtttlNotesToCompiled(struct playRtttlState *aState, rtttlAddress_t aAddress, uint16_t *aCompiledArrayPtr,
+        uint16_t aCompiledArraySize) {
+    if (aCompiledArraySize < RTTTL_COMPILED_HEADER_SIZE + 1) {
+        return 0;
+    }
+    aCompiledArrayPtr[0] = aState->BeatsPerMinute;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    aCompiledArrayPtr[1] = (aState->NumberOfLoops << 8) | aState->StyleDivisorValue;
+#else
+    aCompiledArrayPtr[1] = (1 << 8) | RTTTL_COMPILED_STYLE_DEFAULT;
 #endif
-            tNote++;
-            tRTTTLArrayPtr++;
-            tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
-        }
+    uint16_t tIndex = RTTTL_COMPILED_HEADER_SIZE;
 
-// now, get optional '.' of dotted note
-        if (tChar == '.') {
-            tDuration += tDuration / 2;
-#if defined(LOCAL_DEBUG)
-            tDurationNumber += tDurationNumber / 2;
-#endif
-            tRTTTLArrayPtr++;
-            tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
+    struct rtttlNote tParsedNote;
+    while (Source::readChar(aState, aAddress) != '\0') {
+        if (tIndex >= aCompiledArraySize - 1) {
+            return 0; // no space left for note and end marker
         }
+        aAddress = parseRtttlNote<Source>(aState, aAddress, &tParsedNote);
 
-// now, get octave
-        if (isdigit(tChar)) {
-            tOctave = tChar - '0';
-            tRTTTLArrayPtr++;
-            tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
-        } else {
-            tOctave = sPlayRtttlState.DefaultOctave;
+        uint8_t tDurationExponent = 0;
+        while ((1 << tDurationExponent) < tParsedNote.DurationNumber) {
+            tDurationExponent++;
         }
-
-        if (tChar == '.') {         // believe me I have seen this (e.g. in SilentNight)
-            tDuration += tDuration / 2;
-            tRTTTLArrayPtr++;
-            tChar = getNextCharFromRTTLArray(tRTTTLArrayPtr);
+        if ((1 << tDurationExponent) != tParsedNote.DurationNumber || tDurationExponent > RTTTL_COMPILED_DURATION_MASK) {
+            return 0;
         }
 
-        if (tChar == ',') {
-            tRTTTLArrayPtr++;       // skip comma for next note (or we may be at the end)
+        uint8_t tNote = tParsedNote.Note;
+        uint8_t tOctave = tParsedNote.Octave;
+        if (tNote == 12) {
+            // b# is c of the next octave
+            tNote = 0;
+            tOctave++;
+        } else if (tNote > 12) {
+            tNote = RTTTL_COMPILED_PAUSE;
+            tOctave = 0;
         }
+        aCompiledArrayPtr[tIndex++] = RTTTL_COMPILED_NOTE(tNote, tOctave, tDurationExponent, tParsedNote.NumberOfDots);
+    }
+    aCompiledArrayPtr[tIndex++] = RTTTL_COMPILED_END;
+    return tIndex;
+}
 
-        /*
-         * now play the note
-         */
+/*
+ * Converts RTTTL text in RAM into the compiled format, which can be played by startPlayRtttlCompiled().
+ * The compiled data requires (number of notes + 3) words.
+ * @return number of words written or 0 if buffer is too small or song contains a duration which is not a power of 2
+ */
+uint16_t convertRtttlToCompiled(const char *aRTTTLArrayPtr, uint16_t *aCompiledArrayPtr, uint16_t aCompiledArraySize) {
+    struct playRtttlState tState;
+    setRtttlHeaderDefaults(&tState);
 #if !defined(USE_NO_RTX_EXTENSIONS)
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-        unsigned long tDurationOfTone;
+    tState.StyleDivisorValue = RTTTL_COMPILED_STYLE_DEFAULT;
 #endif
-        if (tNote <= 12) {
-#if defined(__AVR__)
-            uint16_t tFrequency = pgm_read_word(&Notes[tNote]);
-#else
-            uint16_t tFrequency = Notes[tNote];
-#endif // defined(__AVR__)
-            if (tOctave <= NOTES_OCTAVE) {
-                tFrequency >>= (NOTES_OCTAVE - tOctave);
-            } else {
-                tFrequency <<= (tOctave - NOTES_OCTAVE);
-            }
+    rtttlAddress_t tAddress = parseRtttlHeader<RtttlSourceRAM>(&tState, (rtttlAddress_t) aRTTTLArrayPtr);
+    return convertRtttlNotesToCompiled<RtttlSourceRAM>(&tState, tAddress, aCompiledArrayPtr, aCompiledArraySize);
+}
 
-#if defined(ESP32)
-            ledcWriteTone(sPlayRtttlState.TonePin, tFrequency);
+/*
+ * Converts RTTTL text in FLASH into the compiled format.
+ */
+uint16_t convertRtttlToCompiledPGM(const char *aRTTTLArrayPtrPGM, uint16_t *aCompiledArrayPtr, uint16_t aCompiledArraySize) {
+    struct playRtttlState tState;
+    setRtttlHeaderDefaults(&tState);
 #if !defined(USE_NO_RTX_EXTENSIONS)
-            (void) tDurationOfTone; // to avoid compiler warnings
+    tState.StyleDivisorValue = RTTTL_COMPILED_STYLE_DEFAULT;
 #endif
+    rtttlAddress_t tAddress = parseRtttlHeader<RtttlSourcePGM>(&tState, (rtttlAddress_t) aRTTTLArrayPtrPGM);
+    return convertRtttlNotesToCompiled<RtttlSourcePGM>(&tState, tAddress, aCompiledArrayPtr, aCompiledArraySize);
+}
+
+/*
+ * Parses the header and notes of one loop with a struct rtttlDecodeState on the stack, so a playing song is not affected.
+ */
+template<typename Source>
+void getRtttlInfoFromSource(rtttlAddress_t aAddress, struct rtttlInfo *aInfo) {
+    struct rtttlDecodeState tState;
+    setRtttlHeaderDefaults(&tState);
+    aAddress = parseRtttlHeader<Source>(&tState, aAddress);
+
+    aInfo->DefaultDuration = tState.DefaultDuration;
+    aInfo->DefaultOctave = tState.DefaultOctave;
+    aInfo->BeatsPerMinute = tState.BeatsPerMinute;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    aInfo->StyleDivisorValue = tState.StyleDivisorValue;
+    aInfo->NumberOfLoops = tState.NumberOfLoops;
 #else
-#  if !defined(USE_NO_RTX_EXTENSIONS)
-            if (sPlayRtttlState.StyleDivisorValue != 0) {
-                /*
-                 * handle style parameter, compute duration of tone output for note and do rounding for integer division
-                 */
-                tDurationOfTone = tDuration
-                        - ((tDuration + (sPlayRtttlState.StyleDivisorValue / 2)) / sPlayRtttlState.StyleDivisorValue);
-                tone(sPlayRtttlState.TonePin, tFrequency, tDurationOfTone);
-            } else {
-                tone(sPlayRtttlState.TonePin, tFrequency, tDuration);
+    aInfo->StyleDivisorValue = RTTTL_STYLE_DEFAULT;
+    aInfo->NumberOfLoops = 1;
+#endif
+
+    uint32_t tMicrosOfOneLoop = 0;
+    uint16_t tNumberOfNotes = 0;
+    uint16_t tMinimumFrequency = 0xFFFF;
+    uint16_t tMaximumFrequency = 0;
+    struct rtttlNote tParsedNote;
+    while (Source::readChar(&tState, aAddress) != '\0') {
+        aAddress = parseRtttlNote<Source>(&tState, aAddress, &tParsedNote);
+        tMicrosOfOneLoop += computeRtttlNoteDuration(&tState, &tParsedNote);
+        tNumberOfNotes++;
+        uint8_t tNote = tParsedNote.Note;
+        if (tNote <= 12) {
+            uint8_t tOctave = tParsedNote.Octave;
+            if (tNote == 12) {
+                // b# is c of the next octave
+                tNote = 0;
+                tOctave++;
+            }
+            uint16_t tFrequency = getRtttlFrequency(tNote, tOctave);
+            if (tMinimumFrequency > tFrequency) {
+                tMinimumFrequency = tFrequency;
             }
+            if (tMaximumFrequency < tFrequency) {
+                tMaximumFrequency = tFrequency;
+            }
+        }
+    }
 
-#  else
-            /*
-             * Generate the tone
-             */
-            // even without INTERPRETE_RTX_FORMAT the default style is natural (Tone length = note length - 1/16)
-            tone(sPlayRtttlState.TonePin, tFrequency, tDuration - (tDuration >> 4));
-#  endif
-#  if defined(TCCR2A)
-            if (sPlayRtttlState.TonePin == 11) {
-                // switch to direct hardware toggle output at OC2A / pin 11
-                TCCR2A |= _BV(COM2A0);
+    aInfo->NumberOfNotes = tNumberOfNotes;
+    aInfo->MinimumFrequency = (tMaximumFrequency == 0) ? 0 : tMinimumFrequency;
+    aInfo->MaximumFrequency = tMaximumFrequency;
+    aInfo->DurationMillis = (tMicrosOfOneLoop + 500) / 1000;
+    if (aInfo->NumberOfLoops > 1) {
+        aInfo->DurationMillis *= aInfo->NumberOfLoops;
+    }
+}
+
+/*
+ * Computes the duration, the number of notes, the frequency range and the header values of a song in RAM.
+ * Runs in time linear to song length and requires no heap. Only a struct rtttlDecodeState of 10 bytes and not a playRtttlState is on the stack.
+ */
+void getRtttlInfo(const char *aRTTTLArrayPtr, struct rtttlInfo *aInfo) {
+    getRtttlInfoFromSource<RtttlSourceRAM>((rtttlAddress_t) aRTTTLArrayPtr, aInfo);
+}
+
+void getRtttlInfoPGM(const char *aRTTTLArrayPtrPGM, struct rtttlInfo *aInfo) {
+    getRtttlInfoFromSource<RtttlSourcePGM>((rtttlAddress_t) aRTTTLArrayPtrPGM, aInfo);
+}
+
+/*
+ * Stores the start time and address of the notes of one loop in the checkpoints.
+ * If the index is full, every 2nd checkpoint is removed and only every 2nd note of the remaining song gets a checkpoint.
+ */
+template<typename Source>
+void buildRtttlSeekIndexFromSource(rtttlAddress_t aAddress, struct rtttlSeekIndex *aSeekIndex) {
+    struct rtttlDecodeState tState; // only one loop is indexed
+    setRtttlHeaderDefaults(&tState);
+    aAddress = parseRtttlHeader<Source>(&tState, aAddress);
+
+    uint32_t tMicros = 0;
+    uint16_t tNoteIndex = 0;
+    uint16_t tStride = 1; // Every tStride-th note gets a checkpoint
+    uint8_t tNumberOfCheckpoints = 0;
+    struct rtttlNote tParsedNote;
+    while (Source::readChar(&tState, aAddress) != '\0') {
+        if ((tNoteIndex & (tStride - 1)) == 0) {
+            if (tNumberOfCheckpoints == RTTTL_SEEK_INDEX_SIZE) {
+                for (uint_fast8_t i = 0; i < RTTTL_SEEK_INDEX_SIZE / 2; ++i) {
+                    aSeekIndex->Checkpoints[i] = aSeekIndex->Checkpoints[2 * i];
+                }
+                tNumberOfCheckpoints = RTTTL_SEEK_INDEX_SIZE / 2;
+                tStride *= 2;
             }
-            if (sPlayRtttlState.TonePin == 3) {
-                // switch to direct hardware toggle output at OC2B / pin 3. This indeed works :-), despite of the tone() ISR TIMER2_COMPA_vect.
-                TCCR2A |= _BV(COM2B0);
+            if ((tNoteIndex & (tStride - 1)) == 0) {
+                aSeekIndex->Checkpoints[tNumberOfCheckpoints].Micros = tMicros;
+                aSeekIndex->Checkpoints[tNumberOfCheckpoints].Address = aAddress;
+                tNumberOfCheckpoints++;
             }
+        }
+        aAddress = parseRtttlNote<Source>(&tState, aAddress, &tParsedNote);
+        tMicros += computeRtttlNoteDuration(&tState, &tParsedNote);
+        tNoteIndex++;
+    }
+    aSeekIndex->DurationOfLoopMicros = tMicros;
+    aSeekIndex->NumberOfCheckpoints = tNumberOfCheckpoints;
+}
+
+/*
+ * Builds the index for seekPlayRtttl() for a song in RAM in one pass over the song.
+ * Only a struct rtttlDecodeState of 10 bytes and not a playRtttlState is on the stack.
+ */
+void buildRtttlSeekIndex(const char *aRTTTLArrayPtr, struct rtttlSeekIndex *aSeekIndex) {
+    buildRtttlSeekIndexFromSource<RtttlSourceRAM>((rtttlAddress_t) aRTTTLArrayPtr, aSeekIndex);
+}
+
+void buildRtttlSeekIndexPGM(const char *aRTTTLArrayPtrPGM, struct rtttlSeekIndex *aSeekIndex) {
+    buildRtttlSeekIndexFromSource<RtttlSourcePGM>((rtttlAddress_t) aRTTTLArrayPtrPGM, aSeekIndex);
+}
+
+/*
+ * Decodes the notes from NextTonePointer, which starts at aStartMicros, until the note containing aOffsetMicros
+ * and plays the rest of this note.
+ * Returns false and stops the song if aOffsetMicros is behind the end of the song.
+ */
+bool RtttlPlayer::seekFromNote(uint32_t aOffsetMicros, uint32_t aStartMicros) {
+    struct rtttlPreparedNote *tNextNote = &State.NextNote;
+    prepareNextRtttlNote(&State);
+    while (tNextNote->ParseResult == RTTTL_PARSE_OK && aOffsetMicros - aStartMicros >= tNextNote->Duration) {
+        aStartMicros += tNextNote->Duration;
+        prepareNextRtttlNote(&State);
+    }
+    if (tNextNote->ParseResult != RTTTL_PARSE_OK) {
+        stop();
+        return false;
+    }
 
-#  endif
-#endif // defined(ESP32)
+    /*
+     * Play only the rest of the note, so the following notes are in time
+     */
+    uint32_t tElapsedMicros = aOffsetMicros - aStartMicros;
+    unsigned long tElapsedMillis = tElapsedMicros / 1000;
+    tNextNote->Duration -= tElapsedMicros;
+    if (tNextNote->DurationOfTone > tElapsedMillis) {
+        tNextNote->DurationOfTone -= tElapsedMillis;
+    } else {
+        tNextNote->Frequency = 0; // only the gap after the tone is left
+    }
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    tNextNote->DurationOfToneMicros = tNextNote->DurationOfTone * 1000UL;
+#endif
+    State.MicrosOfNextAction = micros();
+    State.IsCompletionPending = false;
+    State.IsRunning = true;
+    update();
+    return true;
+}
 
-        } else {
-            // Play pause, need to handle inverted pin mode here
-#if defined(ESP32)
-            ledcWriteTone(TONE_LEDC_CHANNEL, 0);
+/*
+ * Continues playing the song at aOffsetMillis after the start of the current loop, i.e. after the start of the song,
+ * if called directly after a start function. The note at this time is played with its remaining duration.
+ * Without index, all notes before aOffsetMillis are decoded again. With an index built by buildRtttlSeekIndex()
+ * for the same song, the checkpoint before aOffsetMillis is found by binary search and only the notes after it are decoded.
+ * Without index, USE_NO_RTX_EXTENSIONS must not be defined. Streams cannot be seeked, packed songs only without index.
+ * Returns false if not possible, e.g. for the index of an empty song or for aOffsetMillis > RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS.
+ * With USE_NO_RTX_EXTENSIONS, the index must be built for the current song, since the address of its first note is not stored.
+ * Returns false and stops the song without calling OnComplete if aOffsetMillis is behind the end of the song.
+ */
+bool RtttlPlayer::seek(uint32_t aOffsetMillis, const struct rtttlSeekIndex *aSeekIndex) {
+    if (!State.Flags.IsCompiled && State.ParseNextNote == &parseNextRtttlNoteFromStream) {
+        return false;
+    }
+    bool tIsPacked = !State.Flags.IsCompiled && State.ParseNextNote == &parseNextRtttlNoteFromPacked;
+    if (tIsPacked && aSeekIndex != nullptr) {
+        return false; // the index contains no phrase state
+    }
+    if (aSeekIndex != nullptr && aSeekIndex->NumberOfCheckpoints == 0) {
+        return false; // index of an empty song, it has no Checkpoints[0]
+    }
+    if (aOffsetMillis > RTTTL_SEEK_MAXIMUM_OFFSET_MILLIS) {
+        return false; // the offset in microseconds would overflow
+    }
+#if defined(USE_NO_RTX_EXTENSIONS)
+    if (aSeekIndex == nullptr) {
+        return false; // the address of the first note is not stored
+    }
 #else
-            noTone(sPlayRtttlState.TonePin);
-#if defined(TCCR2A)
-            // reset direct hardware toggle output at OC2A / pin 11 and OC2B / pin 3
-            TCCR2A &= ~(_BV(COM2A0) | _BV(COM2B0));
+    if (aSeekIndex != nullptr && aSeekIndex->Checkpoints[0].Address != State.LastTonePointer) {
+        return false; // index of another song
+    }
+#endif
+    State.IsRunning = false; // keep updateFromInterrupt() off the state until it is set up
+#if defined(RTTTL_OUTPUT_HAS_NO_TONE_DURATION)
+    State.IsToneOn = false;
 #endif
-#endif // defined(ESP32)
+    uint32_t tOffsetMicros = aOffsetMillis * 1000UL;
 
-            if (sPlayRtttlState.Flags.IsTonePinInverted) {
-                digitalWrite(sPlayRtttlState.TonePin, HIGH);
-            }
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    if (aSeekIndex == nullptr) {
+        State.NextTonePointer = State.LastTonePointer;
+        if (tIsPacked) {
+            State.Packed.PhraseEnd = 0;
         }
-#if defined(TRACE)
-        sPointerToSerial->print(F("Playing: NOTE_"));
-        sPointerToSerial->print(tNoteCharUppercase);
-        if (isSharp) {
-            sPointerToSerial->print('#');
+        return seekFromNote(tOffsetMicros, 0);
+    }
+#endif
+
+    uint32_t tDurationOfLoopMicros = aSeekIndex->DurationOfLoopMicros;
+    if (tOffsetMicros >= tDurationOfLoopMicros) {
+#if !defined(USE_NO_RTX_EXTENSIONS)
+        // skip the complete loops before the offset
+        uint32_t tNumberOfLoops = 0xFFFFFFFF; // an empty song ends at every offset
+        if (tDurationOfLoopMicros != 0) {
+            tNumberOfLoops = tOffsetMicros / tDurationOfLoopMicros;
         }
-        if (tNote <= 12) {
-            sPointerToSerial->print(tOctave, 10);
+        if (State.NumberOfLoops != 0) {
+            if (tNumberOfLoops >= State.NumberOfLoops) {
+                stop();
+                return false;
+            }
+            State.NumberOfLoops -= tNumberOfLoops;
         }
-        sPointerToSerial->print(F(", "));
-        sPointerToSerial->print(tDurationNumber, 10);
+        tOffsetMicros -= tNumberOfLoops * tDurationOfLoopMicros;
+#else
+        stop();
+        return false;
+#endif
+    }
 
-        sPointerToSerial->print(F(" | "));
-#  if defined(__AVR__)
-        sPointerToSerial->print(pgm_read_word(&Notes[tNote]) >> (NOTES_OCTAVE - tOctave), 10);
-#  else
-        sPointerToSerial->print(Notes[tNote] >> (NOTES_OCTAVE - tOctave), 10);
-#  endif
-        sPointerToSerial->print(F(" Hz for "));
-#  if !defined(USE_NO_RTX_EXTENSIONS)
-        if (sPlayRtttlState.StyleDivisorValue != 0 && tNote <= 12) {
-            sPointerToSerial->print(tDurationOfTone, 10);
-            sPointerToSerial->print(F(" of "));
+    /*
+     * Binary search for the last checkpoint at or before the offset
+     */
+    uint8_t tLow = 0;
+    uint8_t tHigh = aSeekIndex->NumberOfCheckpoints - 1;
+    while (tLow < tHigh) {
+        uint8_t tMiddle = (tLow + tHigh + 1) / 2;
+        if (aSeekIndex->Checkpoints[tMiddle].Micros <= tOffsetMicros) {
+            tLow = tMiddle;
+        } else {
+            tHigh = tMiddle - 1;
         }
-#  endif
-        sPointerToSerial->print(tDuration, 10);
-        sPointerToSerial->println(F(" ms"));
-
-#endif //TRACE
-        sPlayRtttlState.MillisOfNextAction = tMillis + tDuration;
-        sPlayRtttlState.NextTonePointer = tRTTTLArrayPtr;
     }
-    return true;
+    State.NextTonePointer = aSeekIndex->Checkpoints[tLow].Address;
+    return seekFromNote(tOffsetMicros, aSeekIndex->Checkpoints[tLow].Micros);
 }
 
-void getRtttlName(const char *aRTTTLArrayPtr, char *aBuffer, uint8_t aBuffersize) {
-    char tChar = *aRTTTLArrayPtr++;
-    while (tChar != ':' && aBuffersize > 1) {
-        *aBuffer++ = tChar;
-        aBuffersize--;
-        tChar = *aRTTTLArrayPtr++;
-    }
-    *aBuffer = '\0';
+bool seekPlayRtttl(uint32_t aOffsetMillis, const struct rtttlSeekIndex *aSeekIndex) {
+    return sDefaultRtttlPlayer.seek(aOffsetMillis, aSeekIndex);
 }
 
 /*
- * Prints text "Now playing: Song xy"
- * call it e.g. printNamePGM(RTTTLMelodies[tRandomIndex], &Serial);
+ * Copies the position of the current song into aSnapshot, without stopping it
  */
-void printName(const char *aRTTTLArrayPtr, Print *aSerial) {
-    char tStringBuffer[16];
-    aSerial->print(F("Now playing: "));
-    getRtttlName(aRTTTLArrayPtr, tStringBuffer, sizeof(tStringBuffer));
-    aSerial->println(tStringBuffer);
+void RtttlPlayer::saveSnapshot(struct rtttlSnapshot *aSnapshot) {
+    bool tIsRunning = State.IsRunning;
+    State.IsRunning = false; // keep updateFromInterrupt() off the state while copying
+    int32_t tRemainingMicros = (int32_t) (State.MicrosOfNextAction - (uint32_t) micros());
+    aSnapshot->RemainingMicros = (tRemainingMicros > 0) ? tRemainingMicros : 0;
+    aSnapshot->NextTonePointer = State.NextTonePointer;
+    aSnapshot->ParseNextNote = State.ParseNextNote;
+    static_assert(sizeof(State.Packed) >= sizeof(State.StreamBuffer) && sizeof(State.Packed) >= sizeof(State.ReadCharFunction),
+            "Packed must be the biggest member of the source union");
+    aSnapshot->Source = State.Packed;
+    aSnapshot->OnComplete = State.OnComplete;
+    aSnapshot->NextNote = State.NextNote;
+    aSnapshot->BeatsPerMinute = State.BeatsPerMinute;
+    aSnapshot->DefaultDuration = State.DefaultDuration;
+    aSnapshot->DefaultOctave = State.DefaultOctave;
+    aSnapshot->TonePin = State.TonePin;
+    aSnapshot->IsRunning = tIsRunning;
+    aSnapshot->IsPGMMemory = State.Flags.IsPGMMemory;
+    aSnapshot->IsCompiled = State.Flags.IsCompiled;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    aSnapshot->NumberOfLoops = State.NumberOfLoops;
+    aSnapshot->StyleDivisorValue = State.StyleDivisorValue;
+    aSnapshot->LastTonePointer = State.LastTonePointer;
+#endif
+    State.IsRunning = tIsRunning;
 }
 
 /*
- * Plays one of the songs in the array specified non blocking. Ie. you must call updatePlayRtttl() in your loop or use the callback function.
- * aNumberOfEntriesInSongArrayPGM is (sizeof(<MyArrayName>) / sizeof(char *) - 1)
- * char tStringBuffer[16] is sufficient for most titles.
+ * Stops the current song and continues the song of aSnapshot with the already decoded next note after the remaining time.
+ * No note is parsed again, only the durations are computed from BeatsPerMinute.
  */
-void startPlayRandomRtttlFromArray(uint8_t aTonePin, const char *const aSongArray[], uint8_t aNumberOfEntriesInSongArray,
-        char *aBufferPointer, uint8_t aBufferSize, void (*aOnComplete)()) {
-    uint8_t tRandomIndex = random(0, aNumberOfEntriesInSongArray - 1);
-    char *tSongPtr = (char*) aSongArray[tRandomIndex];
-    startPlayRtttl(aTonePin, tSongPtr, aOnComplete);
-    if (aBufferPointer != nullptr) {
-// copy title to buffer
-        getRtttlName(tSongPtr, aBufferPointer, aBufferSize);
+void RtttlPlayer::restoreSnapshot(const struct rtttlSnapshot *aSnapshot) {
+    stop();
+    State.NextTonePointer = aSnapshot->NextTonePointer;
+    State.ParseNextNote = aSnapshot->ParseNextNote;
+    State.Packed = aSnapshot->Source;
+    State.OnComplete = aSnapshot->OnComplete;
+    State.NextNote = aSnapshot->NextNote;
+    State.BeatsPerMinute = aSnapshot->BeatsPerMinute;
+    State.DefaultDuration = aSnapshot->DefaultDuration;
+    State.DefaultOctave = aSnapshot->DefaultOctave;
+    State.TonePin = aSnapshot->TonePin;
+    State.Flags.IsPGMMemory = aSnapshot->IsPGMMemory;
+    State.Flags.IsCompiled = aSnapshot->IsCompiled;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+    State.NumberOfLoops = aSnapshot->NumberOfLoops;
+    State.StyleDivisorValue = aSnapshot->StyleDivisorValue;
+    State.LastTonePointer = aSnapshot->LastTonePointer;
+#endif
+    initRtttlDurations(&State);
+    if (aSnapshot->IsRunning) {
+        RTTTL_OUTPUT::begin(&State);
+        State.MicrosOfNextAction = micros() + aSnapshot->RemainingMicros;
+        State.IsCompletionPending = false;
+        State.IsRunning = true;
+        update();
     }
 }
 
-void startPlayRandomRtttlFromArrayAndPrintName(uint8_t aTonePin, const char *const aSongArray[],
-        uint8_t aNumberOfEntriesInSongArray, Print *aSerial, void (*aOnComplete)()) {
-    uint8_t tRandomIndex = random(0, aNumberOfEntriesInSongArray - 1);
-    char *tSongPtr = (char*) aSongArray[tRandomIndex];
-    startPlayRtttl(aTonePin, tSongPtr, aOnComplete);
-// print title
-    printName(tSongPtr, aSerial);
+struct rtttlSnapshotStack sRtttlSnapshotStack;
+
+void popPlayRtttlOnComplete() {
+    popPlayRtttl();
 }
 
 /*
- * Plays one of the samples from RTTTLMelodies array
+ * Saves the current song of sDefaultRtttlPlayer on the stack. Returns false if stack is full.
  */
-void playRandomRtttlSampleBlocking(uint8_t aTonePin) {
-    uint8_t tRandomIndex = random(0, sizeof(RTTTLMelodies) / sizeof(char*) - 1);
-    char *tSongPtr = (char*) RTTTLMelodies[tRandomIndex];
-    playRtttlBlocking(aTonePin, tSongPtr);
+bool pushPlayRtttlSnapshot() {
+    if (sRtttlSnapshotStack.NumberOfSnapshots >= RTTTL_SNAPSHOT_STACK_SIZE) {
+        return false;
+    }
+    sDefaultRtttlPlayer.saveSnapshot(&sRtttlSnapshotStack.Snapshots[sRtttlSnapshotStack.NumberOfSnapshots++]);
+    return true;
 }
 
-void playRandomRtttlSampleBlockingAndPrintName(uint8_t aTonePin, Print *aSerial) {
-    uint8_t tRandomIndex = random(0, sizeof(RTTTLMelodies) / sizeof(char*) - 1);
-    char *tSongPtr = (char*) RTTTLMelodies[tRandomIndex];
-    printName(tSongPtr, aSerial);
-    playRtttlBlocking(aTonePin, tSongPtr);
+/*
+ * Interrupts the current song, e.g. for an alert, and plays the RTTTL song in RAM.
+ * At its end, the interrupted song is resumed by popPlayRtttl(). Can be nested up to RTTTL_SNAPSHOT_STACK_SIZE.
+ * Returns false and does not start the song if stack is full.
+ */
+bool pushPlayRtttl(uint8_t aTonePin, const char *aRTTTLArrayPtr) {
+    if (!pushPlayRtttlSnapshot()) {
+        return false;
+    }
+    startPlayRtttl(aTonePin, aRTTTLArrayPtr, &popPlayRtttlOnComplete);
+    return true;
 }
 
-void playRtttlBlockingPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM) {
-    startPlayRtttlPGM(aTonePin, aRTTTLArrayPtrPGM, nullptr);
-    while (updatePlayRtttl()) {
-        delay(1); // this in turn calls yield();
+bool pushPlayRtttlPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM) {
+    if (!pushPlayRtttlSnapshot()) {
+        return false;
     }
+    startPlayRtttlPGM(aTonePin, aRTTTLArrayPtrPGM, &popPlayRtttlOnComplete);
+    return true;
 }
 
-/**
- * @param  aRTTTLArrayPtrPGM a pointer to an PGM array of pointers to PGM song data
+/*
+ * Stops the current song and resumes the song interrupted by the last push at its position.
+ * Returns false if stack is empty.
  */
-void startPlayRtttlPGMPGM(uint8_t aTonePin, const char *const*aRTTTLPGMArrayPtrPGM, void (*aOnComplete)()) {
-#if defined(__AVR__)
-    const char *tRTTTLPGMArrayPtrPGM = (const char*) pgm_read_word(aRTTTLPGMArrayPtrPGM);
-#else
-    const char *tRTTTLPGMArrayPtrPGM = *aRTTTLPGMArrayPtrPGM;
-#endif
-    startPlayRtttlPGM(aTonePin, tRTTTLPGMArrayPtrPGM, aOnComplete);
+bool popPlayRtttl() {
+    if (sRtttlSnapshotStack.NumberOfSnapshots == 0) {
+        return false;
+    }
+    sDefaultRtttlPlayer.restoreSnapshot(&sRtttlSnapshotStack.Snapshots[--sRtttlSnapshotStack.NumberOfSnapshots]);
+    return true;
 }
 
+struct rtttlLivePitch sRtttlLivePitch;
+
+#if defined(TCCR2A)
 /*
- * Non blocking version for RTTTL Data in FLASH. Ie. you must call updatePlayRtttl() in your loop.
- * @param  aRTTTLArrayPtrPGM a pointer to PGM song data
+ * Returns (<prescaler bits> << 8) | <compare value> for Timer2 in CTC mode like the entries of RtttlTimer2Table,
+ * with the smallest prescaler where the compare value fits into 8 bit.
  */
-void startPlayRtttlPGM(uint8_t aTonePin, const char *aRTTTLArrayPtrPGM, void (*aOnComplete)()) {
-    sPlayRtttlState.Flags.IsPGMMemory = true;
-    sPlayRtttlState.OnComplete = aOnComplete;
-    sPlayRtttlState.TonePin = aTonePin;
-
-    int tNumber;
-
-    /*
-     * Skip name and :
-     */
-#if defined(LOCAL_DEBUG)
-    sPointerToSerial->print(F("Title="));
-#endif
-    char tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-    while (tPGMChar != ':') {
-        /*
-         * Read title
-         */
-#if defined(LOCAL_DEBUG)
-        sPointerToSerial->print(tPGMChar);
-#endif
-        aRTTTLArrayPtrPGM++;
-        tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
+// Shifts of the prescalers 1, 8, 32, 64, 128, 256 and 1024 for the CS22 to CS20 bits 1 to 7
+const uint8_t RtttlTimer2PrescalerShifts[] PROGMEM = { 0, 3, 5, 6, 7, 8, 10 };
+
+uint16_t computeRtttlTimer2Entry(uint16_t aFrequency) {
+    uint32_t tHalfPeriodCycles = F_CPU / (2UL * aFrequency); // only to select the prescaler
+    for (uint_fast8_t tPrescalerBits = 1; tPrescalerBits <= 7; ++tPrescalerBits) {
+        uint8_t tShift = pgm_read_byte(&RtttlTimer2PrescalerShifts[tPrescalerBits - 1]);
+        if ((tHalfPeriodCycles >> tShift) <= 256) {
+            // Compare value rounded to nearest, as in PlayRtttlTimerTable.h
+            uint32_t tCompare = ((F_CPU >> tShift) + aFrequency) / (2UL * aFrequency);
+            if (tCompare <= 256) {
+                return (tPrescalerBits << 8) | (tCompare == 0 ? 0 : tCompare - 1);
+            }
+        }
     }
+    return (7 << 8) | 0xFF; // lowest possible frequency
+}
 
-    sPlayRtttlState.DefaultDuration = DEFAULT_DURATION;
-    sPlayRtttlState.DefaultOctave = DEFAULT_OCTAVE;
-    sPlayRtttlState.TimeForWholeNoteMillis = (60 * 1000L / DEFAULT_BPM) * 4;
-#if !defined(USE_NO_RTX_EXTENSIONS)
-    sPlayRtttlState.NumberOfLoops = 1;
-    sPlayRtttlState.StyleDivisorValue = sDefaultStyleDivisorValue;
-#endif
-
-#if !defined(USE_NO_RTX_EXTENSIONS)
-#if defined(LOCAL_DEBUG)
-    char tStyleChar = RTX_STYLE_DEFAULT;
-#else
-    char tStyleChar;
-#endif
-#endif
-    int tBPM = 0;
-
-    do {
-        /*
-         * Get character after separator (comma or colon)
-         */
-        aRTTTLArrayPtrPGM++;
-        tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
+/*
+ * The first tone initializes Timer2 like RtttlOutputTimer2.
+ * A running tone is changed without resetting the counter, so the running half period just ends at the new compare value.
+ * If the prescaler changes, the counter is converted to the new prescaler, so the elapsed time of the half period is kept.
+ * If the counter has already passed the new compare value, it would count up to 255 and give a long half period,
+ * so the half period is ended immediately by a forced compare match.
+ */
+void setRtttlLiveTimer2Entry(uint16_t aTimer2Entry) {
+    uint8_t tCompare = aTimer2Entry & 0xFF;
+    uint8_t tPrescalerBits = aTimer2Entry >> 8;
+    if (sRtttlLivePitch.Frequency == 0) {
+        TIMSK2 = 0; // disable the interrupt of a previous tone()
+        TCCR2B = 0; // stop timer while changing values
+        TCCR2A = _BV(WGM21) | sRtttlLivePitch.Timer2CompareOutputMode; // CTC mode with TOP = OCR2A
+        OCR2A = tCompare;
+        OCR2B = 0; // OC2B toggles at counter value 0, so it has the same frequency as OC2A
+        TCNT2 = 0;
+        TCCR2B = tPrescalerBits;
+    } else if (aTimer2Entry != sRtttlLivePitch.Timer2Entry) {
+        uint8_t tOldPrescalerBits = sRtttlLivePitch.Timer2Entry >> 8;
+        bool tIsOC2A = (sRtttlLivePitch.Timer2CompareOutputMode == _BV(COM2A0));
+        uint8_t tSREG = SREG;
+        cli();
+        uint8_t tCounter = TCNT2;
+        OCR2A = tCompare;
         /*
-         * Read song info with format: d=N(N),o=N,b=NNN:
+         * Timer clocks since the last edge. OC2A toggles when the counter reaches OCR2A, OC2B when it is cleared to 0.
+         * For OC2A, a counter at the old OCR2A is set to 0xFF, to start the half period at the next timer clock.
          */
-        if (tPGMChar == 'd') {
-            /*
-             * get default duration
-             */
-            aRTTTLArrayPtrPGM++;
-            aRTTTLArrayPtrPGM++;              // skip "d="
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            tNumber = 0;
-            while (isdigit(tPGMChar)) {
-                tNumber = (tNumber * 10) + (tPGMChar - '0');
-                aRTTTLArrayPtrPGM++;
-                tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            }
-            if (tNumber == 0) {
-                tNumber = DEFAULT_DURATION;
+        uint16_t tElapsedClocks = tCounter;
+        bool tWriteCounter = false;
+        if (tIsOC2A) {
+            if (tCounter == (uint8_t) sRtttlLivePitch.Timer2Entry) {
+                tElapsedClocks = 0;
+                tWriteCounter = true;
+            } else {
+                tElapsedClocks++;
             }
-            sPlayRtttlState.DefaultDuration = tNumber;
-        } else if (tPGMChar == 'o') {
+        }
+        if (tPrescalerBits != tOldPrescalerBits) {
+            tElapsedClocks = ((uint32_t) tElapsedClocks << pgm_read_byte(&RtttlTimer2PrescalerShifts[tOldPrescalerBits - 1]))
+                    >> pgm_read_byte(&RtttlTimer2PrescalerShifts[tPrescalerBits - 1]);
+            tWriteCounter = true;
+        }
+        if (tElapsedClocks > tCompare || (tWriteCounter && tElapsedClocks == tCompare)) {
             /*
-             * get default octave
+             * End the half period now. Writing TCNT2 blocks the compare match at the next timer clock,
+             * so the pin is toggled only by the forced match. The prescaler reset gives an exact next half period.
              */
-            aRTTTLArrayPtrPGM++;
-            aRTTTLArrayPtrPGM++;              // skip "o="
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            tNumber = tPGMChar - '0';
-            if (tNumber < 3 && tNumber > 7) {
-                tNumber = DEFAULT_OCTAVE;
-            }
-            sPlayRtttlState.DefaultOctave = tNumber;
-            //get comma or colon
-            aRTTTLArrayPtrPGM++;
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-        } else
-
-#if !defined(USE_NO_RTX_EXTENSIONS)
-        if (tPGMChar == 's') {
-            // get Style
-            aRTTTLArrayPtrPGM++;
-            aRTTTLArrayPtrPGM++;              // skip "s="
-            tStyleChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            tNumber = convertStyleCharacterToDivisorValue(tStyleChar);
-            sPlayRtttlState.StyleDivisorValue = tNumber;
-            //get comma or colon
-            aRTTTLArrayPtrPGM++;
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-        } else if (tPGMChar == 'l') {
-            // get loops
-            aRTTTLArrayPtrPGM++;
-            aRTTTLArrayPtrPGM++;              // skip "l="
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            tNumber = 0;
-            while (isdigit(tPGMChar)) {
-                tNumber = (tNumber * 10) + (tPGMChar - '0');
-                aRTTTLArrayPtrPGM++;
-                tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            }
-            if (tNumber == 15) {
-                tNumber = 0;
+            TCNT2 = tIsOC2A ? 0xFF : 0;
+#if defined(PSRASY)
+            GTCCR = _BV(PSRASY);
+#endif
+            TCCR2B = tPrescalerBits | (tIsOC2A ? _BV(FOC2A) : _BV(FOC2B));
+        } else {
+            if (tWriteCounter) {
+                TCNT2 = tIsOC2A ? tElapsedClocks - 1 : tElapsedClocks; // 0xFF for 0 elapsed clocks of OC2A
             }
-            sPlayRtttlState.NumberOfLoops = tNumber;
-        } else
+            TCCR2B = tPrescalerBits;
+        }
+        SREG = tSREG;
+    }
+    sRtttlLivePitch.Timer2Entry = aTimer2Entry;
+}
 #endif
 
-        // get BPM
-        if (tPGMChar == 'b') {
-            aRTTTLArrayPtrPGM++;
-            aRTTTLArrayPtrPGM++;              // skip "b="
-            tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            while (isdigit(tPGMChar)) {
-                tBPM = (tBPM * 10) + (tPGMChar - '0');
-                aRTTTLArrayPtrPGM++;
-                tPGMChar = pgm_read_byte(aRTTTLArrayPtrPGM);
-            }
-            if (tBPM == 0) {
-                tBPM = DEFAULT_BPM;
-            }
-            // BPM usually expresses the number of quarter notes per minute
-            sPlayRtttlState.TimeForWholeNoteMillis = (60 * 1000L / tBPM) * 4;
+/*
+ * aTimer2Entry is 0 if it must be computed for aFrequency
+ */
+void setRtttlLivePitch(uint8_t aTonePin, uint16_t aFrequency, uint16_t aTimer2Entry) {
+    if (aFrequency == 0) {
+        stopLivePitch();
+        return;
+    }
+    if (aTonePin != sRtttlLivePitch.TonePin || sRtttlLivePitch.Frequency == 0) {
+        stopLivePitch();
+        sRtttlLivePitch.TonePin = aTonePin;
+#if defined(TCCR2A)
+        uint8_t tTimer = digitalPinToTimer(aTonePin);
+        sRtttlLivePitch.Timer2CompareOutputMode = (tTimer == TIMER2A) ? _BV(COM2A0) : ((tTimer == TIMER2B) ? _BV(COM2B0) : 0);
+        if (sRtttlLivePitch.Timer2CompareOutputMode != 0) {
+            pinMode(aTonePin, OUTPUT);
         }
+#endif
+    } else if (aFrequency == sRtttlLivePitch.Frequency) {
+        return; // no restart of tone()
+    }
 
-    } while (tPGMChar != ':');
+#if defined(TCCR2A)
+    if (sRtttlLivePitch.Timer2CompareOutputMode != 0) {
+        setRtttlLiveTimer2Entry(aTimer2Entry != 0 ? aTimer2Entry : computeRtttlTimer2Entry(aFrequency));
+    } else {
+        tone(aTonePin, aFrequency);
+    }
+#else
+    (void) aTimer2Entry;
+    tone(aTonePin, aFrequency);
+#endif
+    sRtttlLivePitch.Frequency = aFrequency;
+}
 
-    aRTTTLArrayPtrPGM++; // skip colon
+/*
+ * Plays aFrequency until the next call or stopLivePitch(). 0 stops the tone.
+ */
+void setLivePitch(uint8_t aTonePin, uint16_t aFrequency) {
+    setRtttlLivePitch(aTonePin, aFrequency, 0);
+}
 
-#if defined(LOCAL_DEBUG)
-    sPointerToSerial->print(F(" DefaultDuration="));
-    sPointerToSerial->print(sPlayRtttlState.DefaultDuration);
-    sPointerToSerial->print(F(" DefaultOctave="));
-    sPointerToSerial->print(sPlayRtttlState.DefaultOctave);
-    sPointerToSerial->print(F(" BPM="));
-    sPointerToSerial->print(tBPM);
-#if !defined(USE_NO_RTX_EXTENSIONS)
-    sPointerToSerial->print(F(" Style="));
-    sPointerToSerial->print(tStyleChar);
-    if (sPlayRtttlState.StyleDivisorValue != 0) {
-        sPointerToSerial->print(F(" -> 1/"));
-        sPointerToSerial->print(sPlayRtttlState.StyleDivisorValue);
-        sPointerToSerial->print(F(" pause between notes,"));
+/*
+ * Plays the note of Notes[aNoteIndex] in aOctave, e.g. setLiveNote(TONE_PIN, 9, 4) for a4 with 440 Hz.
+ * Note indexes above 11 are ignored, octaves above RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE are played in RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE.
+ * With USE_DIRECT_TIMER2_OUTPUT, the Timer2 values are taken from RtttlTimer2Table, so no division is required.
+ */
+void setLiveNote(uint8_t aTonePin, uint8_t aNoteIndex, uint8_t aOctave) {
+    if (aNoteIndex >= sizeof(Notes) / sizeof(Notes[0])) {
+        return;
     }
-    sPointerToSerial->print(F(" Loops="));
-    sPointerToSerial->print(sPlayRtttlState.NumberOfLoops);
-#endif
-    sPointerToSerial->println();
+    if (aOctave > RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE) {
+        aOctave = RTTTL_LIVE_PITCH_MAXIMUM_OCTAVE;
+    }
+    uint16_t tFrequency = getRtttlFrequency(aNoteIndex, aOctave);
+#if defined(USE_DIRECT_TIMER2_OUTPUT)
+    if (aOctave >= RTTTL_TIMER2_TABLE_OCTAVES) {
+        aOctave = RTTTL_TIMER2_TABLE_OCTAVES - 1;
+    }
+    setRtttlLivePitch(aTonePin, tFrequency, pgm_read_word(&RtttlTimer2Table[aOctave][aNoteIndex]));
+#else
+    setRtttlLivePitch(aTonePin, tFrequency, 0);
 #endif
+}
 
-    sPlayRtttlState.MillisOfNextAction = 0;
-    sPlayRtttlState.NextTonePointer = aRTTTLArrayPtrPGM;
-#if !defined(USE_NO_RTX_EXTENSIONS)
-    sPlayRtttlState.LastTonePointer = aRTTTLArrayPtrPGM;
+void stopLivePitch() {
+    if (sRtttlLivePitch.Frequency == 0) {
+        return;
+    }
+#if defined(TCCR2A)
+    if (sRtttlLivePitch.Timer2CompareOutputMode != 0) {
+        // disconnect the pin, so it has the level of its port bit
+        TCCR2B = 0;
+        TCCR2A = 0;
+    } else {
+        noTone(sRtttlLivePitch.TonePin);
+    }
+#else
+    noTone(sRtttlLivePitch.TonePin);
 #endif
-    sPlayRtttlState.Flags.IsRunning = true;
-
-    /*
-     * Play first tone
-     */
-    updatePlayRtttl();
+    // Inverted pin mode is taken from the default player, set by setTonePinIsInverted()
+    digitalWrite(sRtttlLivePitch.TonePin, sPlayRtttlState.Flags.IsTonePinInverted ? HIGH : LOW);
+    sRtttlLivePitch.Frequency = 0;
 }
 
 /**
@@ -883,22 +2848,57 @@ void playRandomRtttlSampleBlockingPGMAndPrintName(uint8_t aTonePin, Print *aSeri
 #endif
 }
 
+void RtttlPlayer::setTonePinIsInverted(bool aTonePinIsInverted) {
+    State.Flags.IsTonePinInverted = aTonePinIsInverted;
+}
+
 void setTonePinIsInverted(bool aTonePinIsInverted) {
-    sPlayRtttlState.Flags.IsTonePinInverted = aTonePinIsInverted;
+    sDefaultRtttlPlayer.setTonePinIsInverted(aTonePinIsInverted);
+}
+
+/*
+ * RTTTL_LATE_POLICY_SHIFT (default), RTTTL_LATE_POLICY_SHORTEN or RTTTL_LATE_POLICY_DROP
+ */
+void RtttlPlayer::setLatePolicy(uint8_t aLatePolicy) {
+    State.Flags.LatePolicy = aLatePolicy;
+}
+
+uint16_t RtttlPlayer::getNumberOfShortenedNotes() {
+    return State.NumberOfShortenedNotes;
+}
+
+uint16_t RtttlPlayer::getNumberOfDroppedNotes() {
+    return State.NumberOfDroppedNotes;
+}
+
+void setPlayRtttlLatePolicy(uint8_t aLatePolicy) {
+    sDefaultRtttlPlayer.setLatePolicy(aLatePolicy);
+}
+
+uint16_t getPlayRtttlNumberOfShortenedNotes() {
+    return sDefaultRtttlPlayer.getNumberOfShortenedNotes();
+}
+
+uint16_t getPlayRtttlNumberOfDroppedNotes() {
+    return sDefaultRtttlPlayer.getNumberOfDroppedNotes();
 }
 
 #if !defined(USE_NO_RTX_EXTENSIONS)
 /*
  * 0 means forever
  */
-void setNumberOfLoops(uint8_t aNumberOfLoops) {
-    sPlayRtttlState.NumberOfLoops = aNumberOfLoops;
+void RtttlPlayer::setNumberOfLoops(uint8_t aNumberOfLoops) {
+    State.NumberOfLoops = aNumberOfLoops;
 #if defined(LOCAL_DEBUG)
     sPointerToSerial->print(F("Set NumberOfLoops to "));
-    sPointerToSerial->println(sPlayRtttlState.NumberOfLoops);
+    sPointerToSerial->println(State.NumberOfLoops);
 #endif
 }
 
+void setNumberOfLoops(uint8_t aNumberOfLoops) {
+    sDefaultRtttlPlayer.setNumberOfLoops(aNumberOfLoops);
+}
+
 /*
  * Set the divisor for formula: Tone length = note length - note length * (1 / divisor)
  * Default is 16 / RTTTL_STYLE_NATURAL
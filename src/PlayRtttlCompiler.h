@@ -0,0 +1,300 @@
+/*
+ * PlayRtttlCompiler.h
+ *
+ * Compiles RTTTL strings at build time into the compiled format of PlayRtttl, which can be played by startPlayRtttlCompiledPGM().
+ * Requires C++17 and is included by PlayRtttl.hpp if available.
+ *
+ * Usage:
+ * static const auto StarWarsCompiled PROGMEM = RTTTL_COMPILE("StarWars:d=32,o=5,b=45,l=2:p,f#,f#,f#,8b.,8f#.6");
+ * ...
+ * startPlayRtttlCompiledPGM(TONE_PIN, StarWarsCompiled.Words);
+ *
+ * Only the compiled words are stored in FLASH, the RTTTL text is not.
+ * Malformed songs are reported by static_assert.
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+
+#ifndef _PLAY_RTTTL_COMPILER_H
+#define _PLAY_RTTTL_COMPILER_H
+
+#include "PlayRtttl.h"
+
+/*
+ * Values of RtttlCompiler::Result::Error
+ */
+#define RTTTL_COMPILER_OK                       0
+#define RTTTL_COMPILER_ERROR_NO_NAME_END        1 // No ':' after name
+#define RTTTL_COMPILER_ERROR_NO_HEADER_END      2 // No ':' after header
+#define RTTTL_COMPILER_ERROR_INVALID_BPM        3 // BPM > 0xFFFF
+#define RTTTL_COMPILER_ERROR_INVALID_NOTE       4 // Note character not in 'a' to 'h' or 'p'
+#define RTTTL_COMPILER_ERROR_INVALID_DURATION   5 // Duration not 1, 2, 4, ... 128
+#define RTTTL_COMPILER_ERROR_NO_COMMA           6 // Unexpected character after note
+#define RTTTL_COMPILER_ERROR_INVALID_OCTAVE     7 // Octave > 15 after b# conversion
+#define RTTTL_COMPILER_ERROR_INVALID_LOOPS      8 // Loops > 0xFF, they do not fit into the 8 bit of the compiled header
+
+namespace RtttlCompiler {
+
+/*
+ * The number of entries of the Notes[] array, which is indexed by the compiled note index
+ */
+constexpr uint8_t NUMBER_OF_NOTES = 12;
+
+struct Result {
+    uint8_t Error;
+    uint16_t Size; // Number of words including header and end marker
+};
+
+template<uint16_t tSize>
+struct CompiledRtttl {
+    uint16_t Words[tSize] { };
+};
+
+constexpr bool isDigit(char aChar) {
+    return aChar >= '0' && aChar <= '9';
+}
+
+/*
+ * Same parsing rules as parseRtttlHeader() and parseRtttlNote(), but with bounds and syntax checks.
+ * If aCompiledArrayPtr is nullptr, only the size is computed.
+ */
+constexpr Result compile(const char *aRTTTLArrayPtr, uint16_t *aCompiledArrayPtr) {
+    /*
+     * Skip name and :
+     */
+    while (*aRTTTLArrayPtr != ':') {
+        if (*aRTTTLArrayPtr == '\0') {
+            return {RTTTL_COMPILER_ERROR_NO_NAME_END, 0};
+        }
+        aRTTTLArrayPtr++;
+    }
+
+    uint8_t tDefaultDuration = DEFAULT_DURATION;
+    uint8_t tDefaultOctave = DEFAULT_OCTAVE;
+    long tBPM = 0;
+    uint8_t tNumberOfLoops = 1;
+    uint8_t tStyleDivisorValue = RTTTL_COMPILED_STYLE_DEFAULT;
+
+    do {
+        aRTTTLArrayPtr++;
+        char tChar = *aRTTTLArrayPtr;
+        if (tChar == '\0') {
+            return {RTTTL_COMPILER_ERROR_NO_HEADER_END, 0};
+        }
+        if (tChar == 'd' || tChar == 'o' || tChar == 'b'
+#if !defined(USE_NO_RTX_EXTENSIONS)
+                || tChar == 's' || tChar == 'l'
+#endif
+                ) {
+            aRTTTLArrayPtr++;
+            if (*aRTTTLArrayPtr == '\0') {
+                return {RTTTL_COMPILER_ERROR_NO_HEADER_END, 0};
+            }
+            aRTTTLArrayPtr++; // skip "x="
+            if (tChar == 'o') {
+                uint8_t tNumber = *aRTTTLArrayPtr - '0';
+                if (*aRTTTLArrayPtr == '\0') {
+                    return {RTTTL_COMPILER_ERROR_NO_HEADER_END, 0};
+                }
+                aRTTTLArrayPtr++;
+                if (tNumber < 3 || tNumber > 7) {
+                    tNumber = DEFAULT_OCTAVE; // like parseRtttlHeader()
+                }
+                tDefaultOctave = tNumber;
+#if !defined(USE_NO_RTX_EXTENSIONS)
+            } else if (tChar == 's') {
+                char tStyleChar = *aRTTTLArrayPtr;
+                if (tStyleChar == '\0') {
+                    return {RTTTL_COMPILER_ERROR_NO_HEADER_END, 0};
+                }
+                aRTTTLArrayPtr++;
+                // same as convertStyleCharacterToDivisorValue()
+                if (tStyleChar == RTX_STYLE_STACCATO) {
+                    tStyleDivisorValue = 2;
+                } else if (tStyleChar == RTX_STYLE_NATURAL) {
+                    tStyleDivisorValue = 16;
+                } else if (tStyleChar > '0' && tStyleChar <= '9') {
+                    tStyleDivisorValue = tStyleChar - '0';
+                } else {
+                    tStyleDivisorValue = 0;
+                }
+#endif
+            } else {
+                long tNumber = (tChar == 'b') ? tBPM : 0; // BPM digits are accumulated as in parseRtttlHeader()
+                while (isDigit(*aRTTTLArrayPtr)) {
+                    tNumber = (tNumber * 10) + (*aRTTTLArrayPtr++ - '0');
+                    if (tNumber > 0xFFFF) {
+                        return {RTTTL_COMPILER_ERROR_INVALID_BPM, 0};
+                    }
+                }
+                if (tChar == 'd') {
+                    tDefaultDuration = (tNumber == 0) ? DEFAULT_DURATION : tNumber;
+                } else if (tChar == 'b') {
+                    tBPM = (tNumber == 0) ? DEFAULT_BPM : tNumber;
+                } else {
+                    if (tNumber > 0xFF) {
+                        return {RTTTL_COMPILER_ERROR_INVALID_LOOPS, 0};
+                    }
+                    tNumberOfLoops = (tNumber == 15) ? 0 : tNumber;
+                }
+            }
+        }
+        if (*aRTTTLArrayPtr == '\0') {
+            return {RTTTL_COMPILER_ERROR_NO_HEADER_END, 0};
+        }
+    } while (*aRTTTLArrayPtr != ':');
+    aRTTTLArrayPtr++; // skip colon
+
+    if (tBPM == 0) {
+        tBPM = DEFAULT_BPM;
+    }
+    if (aCompiledArrayPtr != nullptr) {
+        aCompiledArrayPtr[0] = tBPM;
+        aCompiledArrayPtr[1] = (tNumberOfLoops << 8) | tStyleDivisorValue;
+    }
+    uint16_t tIndex = RTTTL_COMPILED_HEADER_SIZE;
+
+    while (*aRTTTLArrayPtr != '\0') {
+        uint8_t tDurationNumber = 0;
+        while (isDigit(*aRTTTLArrayPtr)) {
+            tDurationNumber = (tDurationNumber * 10) + (*aRTTTLArrayPtr++ - '0');
+        }
+        if (tDurationNumber == 0) {
+            tDurationNumber = tDefaultDuration;
+        }
+        uint8_t tDurationExponent = 0;
+        while (tDurationExponent <= RTTTL_COMPILED_DURATION_MASK && (1 << tDurationExponent) != tDurationNumber) {
+            tDurationExponent++;
+        }
+        if (tDurationExponent > RTTTL_COMPILED_DURATION_MASK) {
+            return {RTTTL_COMPILER_ERROR_INVALID_DURATION, 0};
+        }
+
+        uint8_t tNote = 0;
+        switch (*aRTTTLArrayPtr) {
+        case 'c':
+            tNote = 0;
+            break;
+        case 'd':
+            tNote = 2;
+            break;
+        case 'e':
+            tNote = 4;
+            break;
+        case 'f':
+            tNote = 5;
+            break;
+        case 'g':
+            tNote = 7;
+            break;
+        case 'a':
+            tNote = 9;
+            break;
+        case 'b':
+        case 'h':
+            tNote = 11;
+            break;
+        case 'p':
+            tNote = RTTTL_COMPILED_PAUSE;
+            break;
+        default:
+            return {RTTTL_COMPILER_ERROR_INVALID_NOTE, 0};
+        }
+        aRTTTLArrayPtr++;
+
+        if (*aRTTTLArrayPtr == '#' || *aRTTTLArrayPtr == '_') {
+            if (tNote != RTTTL_COMPILED_PAUSE) {
+                tNote++;
+            }
+            aRTTTLArrayPtr++;
+        }
+
+        uint8_t tNumberOfDots = 0;
+        if (*aRTTTLArrayPtr == '.') {
+            tNumberOfDots++;
+            aRTTTLArrayPtr++;
+        }
+
+        uint8_t tOctave = tDefaultOctave;
+        if (isDigit(*aRTTTLArrayPtr)) {
+            tOctave = *aRTTTLArrayPtr++ - '0';
+        }
+
+        if (*aRTTTLArrayPtr == '.') {
+            tNumberOfDots++;
+            aRTTTLArrayPtr++;
+        }
+
+        if (*aRTTTLArrayPtr == ',') {
+            aRTTTLArrayPtr++;
+        } else if (*aRTTTLArrayPtr != '\0') {
+            return {RTTTL_COMPILER_ERROR_NO_COMMA, 0};
+        }
+
+        if (tNote == NUMBER_OF_NOTES) {
+            // b# is c of the next octave
+            tNote = 0;
+            tOctave++;
+        } else if (tNote == RTTTL_COMPILED_PAUSE) {
+            tOctave = 0;
+        }
+        if (tOctave > RTTTL_COMPILED_OCTAVE_MASK) {
+            return {RTTTL_COMPILER_ERROR_INVALID_OCTAVE, 0};
+        }
+
+        if (aCompiledArrayPtr != nullptr) {
+            aCompiledArrayPtr[tIndex] = RTTTL_COMPILED_NOTE(tNote, tOctave, tDurationExponent, tNumberOfDots);
+        }
+        tIndex++;
+    }
+    if (aCompiledArrayPtr != nullptr) {
+        aCompiledArrayPtr[tIndex] = RTTTL_COMPILED_END;
+    }
+    tIndex++;
+    return {RTTTL_COMPILER_OK, tIndex};
+}
+
+template<uint16_t tSize>
+constexpr CompiledRtttl<tSize> compileToArray(const char *aRTTTLArrayPtr) {
+    CompiledRtttl<tSize> tCompiled { };
+    compile(aRTTTLArrayPtr, tCompiled.Words);
+    return tCompiled;
+}
+
+} // namespace RtttlCompiler
+
+/*
+ * Returns a CompiledRtttl object for the RTTTL string literal, which is completely evaluated by the compiler.
+ * The words to be passed to startPlayRtttlCompiledPGM() are in member Words.
+ */
+#define RTTTL_COMPILE(aRTTTLString) []() constexpr { \
+    constexpr RtttlCompiler::Result tResult = RtttlCompiler::compile(aRTTTLString, nullptr); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_NO_NAME_END, "RTTTL: No ':' found after name"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_NO_HEADER_END, "RTTTL: No ':' found after header / options"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_INVALID_BPM, "RTTTL: Number in header is greater than 65535"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_INVALID_NOTE, "RTTTL: Note must be one of a, b, c, d, e, f, g, h or p"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_INVALID_DURATION, "RTTTL: Duration must be 1, 2, 4, 8, 16, 32, 64 or 128"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_NO_COMMA, "RTTTL: Notes must be separated by ','"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_INVALID_OCTAVE, "RTTTL: Octave is too high"); \
+    static_assert(tResult.Error != RTTTL_COMPILER_ERROR_INVALID_LOOPS, "RTTTL: Number of loops is greater than 255"); \
+    return RtttlCompiler::compileToArray<tResult.Size>(aRTTTLString); \
+}()
+
+#endif // _PLAY_RTTTL_COMPILER_H
@@ -0,0 +1,111 @@
+/*
+ * PlayRtttlPackedMelodies.h
+ *
+ * 21 songs in the packed format for startPlayRtttlPackedPGM(), generated by extras/host/RtttlPack.
+ * 1153 bytes, RTTTL text 3815 bytes, compiled format 1994 bytes, 27 phrases.
+ *
+ * Index of the songs:
+ *  0 StarWars
+ *  1 MahnaMahna
+ *  2 LeisureSuit
+ *  3 MissionImp
+ *  4 Flinstones
+ *  5 YMCA
+ *  6 MammaMia
+ *  7 Indiana
+ *  8 TakeOnMe
+ *  9 Entertainer
+ * 10 Muppets
+ * 11 IHaveADr
+ * 12 20thCenFox
+ * 13 Bond
+ * 14 GoodBad
+ * 15 PinkPanther
+ * 16 A-Team
+ * 17 Jeopardy
+ * 18 Gadget
+ * 19 Smurfs
+ * 20 Toccata
+ */
+
+#ifndef _PLAY_RTTTL_PACKED_MELODIES_H
+#define _PLAY_RTTTL_PACKED_MELODIES_H
+
+#include <Arduino.h>
+
+static const uint8_t RTTTLMelodiesPacked[] PROGMEM = {
+    0x15, 0x1B, 0xCA, 0x02, 0xEF, 0x02, 0x4B, 0x03, 0xCD, 0x03, 0x33, 0x04, 0xC1, 0x04, 0xF9, 0x04,
+    0x4B, 0x05, 0xB5, 0x05, 0xCE, 0x05, 0x13, 0x06, 0x3F, 0x06, 0x65, 0x06, 0xF7, 0x06, 0x1E, 0x07,
+    0x54, 0x07, 0x99, 0x07, 0xE4, 0x07, 0x4C, 0x08, 0x6B, 0x08, 0xCF, 0x08, 0xC8, 0x00, 0xCD, 0x00,
+    0xDF, 0x00, 0xFF, 0x00, 0x1F, 0x01, 0x3F, 0x01, 0x5E, 0x01, 0x7D, 0x01, 0x9C, 0x01, 0xBA, 0x01,
+    0xD7, 0x01, 0xE7, 0x01, 0x03, 0x02, 0x1E, 0x02, 0x37, 0x02, 0x48, 0x02, 0x59, 0x02, 0x6A, 0x02,
+    0x73, 0x02, 0x81, 0x02, 0x8F, 0x02, 0x9D, 0x02, 0xA5, 0x02, 0xAD, 0x02, 0xB5, 0x02, 0xB9, 0x02,
+    0xBF, 0x02, 0xCA, 0x02, 0xD5, 0xCD, 0x45, 0xAE, 0x63, 0xE5, 0xAE, 0x63, 0xDB, 0xE5, 0xAD, 0xC3,
+    0xCD, 0x47, 0xD3, 0xCD, 0x4A, 0xCE, 0x70, 0xCE, 0x67, 0xD3, 0xCD, 0x47, 0xD3, 0xCD, 0x45, 0xC3,
+    0xE5, 0x23, 0x4D, 0x2E, 0x60, 0xD3, 0xE5, 0x4D, 0x2E, 0x60, 0xD3, 0xE5, 0x4D, 0x9E, 0x60, 0xD6,
+    0x2C, 0xE4, 0xBC, 0xE5, 0x4C, 0x4C, 0x48, 0x89, 0xB9, 0x99, 0x4C, 0x2C, 0x6C, 0x6C, 0x64, 0x45,
+    0xAD, 0x1C, 0xD3, 0xA8, 0x68, 0xAD, 0x2E, 0x61, 0xD3, 0xE5, 0xAD, 0x2E, 0x61, 0xD3, 0x3E, 0xDA,
+    0x7D, 0x2C, 0x44, 0x75, 0xD3, 0x4D, 0x25, 0xD3, 0xE6, 0x0E, 0x50, 0x2D, 0x24, 0xD3, 0x4E, 0x6A,
+    0xD5, 0x7D, 0x45, 0xDC, 0xE5, 0xAD, 0x4E, 0x65, 0xD5, 0x32, 0x23, 0x5D, 0x4E, 0x5A, 0x1D, 0x53,
+    0x3D, 0x43, 0xD3, 0x3D, 0x41, 0x11, 0x1D, 0x54, 0x4D, 0x44, 0xD3, 0x4D, 0x43, 0x1D, 0x5C, 0xD3,
+    0x3D, 0x5C, 0xD3, 0xE5, 0xBD, 0x5C, 0xD2, 0x8D, 0x4C, 0xD2, 0xE6, 0x11, 0xDC, 0x0D, 0x4E, 0x5B,
+    0xDB, 0xAE, 0x65, 0xDD, 0x2E, 0x60, 0x0E, 0x59, 0xBD, 0x39, 0xD2, 0xB7, 0xCE, 0x60, 0x0E, 0x59,
+    0xD3, 0xB6, 0xDA, 0xE6, 0x3D, 0x31, 0xD9, 0x4D, 0x2E, 0x56, 0xDA, 0xBD, 0x3A, 0xD9, 0xBD, 0x34,
+    0xDB, 0x6D, 0x48, 0xD2, 0x6D, 0x91, 0xD3, 0x13, 0xDB, 0x4D, 0x46, 0xD4, 0xD3, 0xCD, 0x22, 0xD3,
+    0xCE, 0x57, 0xDA, 0xE6, 0xD2, 0xE5, 0x4D, 0x3C, 0x57, 0xCD, 0x0E, 0x60, 0xDD, 0x5E, 0x53, 0x56,
+    0x8D, 0x4A, 0x69, 0x58, 0x6D, 0xD4, 0x5D, 0xCE, 0x5A, 0xD0, 0x50, 0xE5, 0x5E, 0x60, 0x5D, 0x10,
+    0xD3, 0x83, 0xE5, 0x8E, 0x63, 0x8D, 0x13, 0xDD, 0x35, 0xD2, 0x3D, 0x38, 0xD4, 0x88, 0x87, 0xDB,
+    0x3D, 0x45, 0xDB, 0xD3, 0xCD, 0x4B, 0xBE, 0x5A, 0x7D, 0x1E, 0x6D, 0x4C, 0xDD, 0x4E, 0x5A, 0xD1,
+    0xDB, 0xBD, 0xC6, 0xD5, 0x43, 0x02, 0xD2, 0xFF, 0xD5, 0xCE, 0x56, 0x66, 0xDB, 0xBE, 0x66, 0xD5,
+    0x43, 0xF1, 0xAF, 0x1A, 0x4D, 0x31, 0xFF, 0xF0, 0x7D, 0x1F, 0xFD, 0x4E, 0x6F, 0x0A, 0x28, 0xD4,
+    0xAD, 0xC7, 0xD2, 0x3D, 0x3C, 0xD4, 0xF0, 0xAC, 0x8D, 0xBA, 0xD2, 0x7D, 0x3C, 0xD4, 0xF0, 0xA2,
+    0x8D, 0x45, 0xDC, 0xF1, 0x5C, 0xF1, 0x53, 0xF1, 0x53, 0x7D, 0x43, 0xD3, 0x0F, 0x19, 0xBE, 0x63,
+    0x3D, 0xC3, 0x3D, 0xB3, 0xFF, 0xF0, 0x38, 0x1F, 0xFD, 0xCE, 0x55, 0x67, 0xD4, 0x8D, 0x5A, 0xD4,
+    0x5D, 0xC8, 0xAD, 0x55, 0xD4, 0x8D, 0x5A, 0xD4, 0x8D, 0xBE, 0x61, 0xF1, 0x95, 0xE6, 0x1D, 0x4E,
+    0x59, 0xDC, 0xAE, 0x61, 0xD5, 0xE5, 0x9D, 0x4A, 0xD5, 0xE6, 0x1D, 0x43, 0xD3, 0x4D, 0xC1, 0x55,
+    0x55, 0xD4, 0x5D, 0x54, 0xD4, 0x3D, 0x32, 0xDC, 0xE5, 0xAD, 0x4E, 0x64, 0xD5, 0x5D, 0x44, 0xD5,
+    0x5D, 0x41, 0xDC, 0x3D, 0x41, 0xFF, 0xF0, 0x5F, 0x1F, 0xFD, 0x5E, 0x62, 0x32, 0x32, 0x32, 0x32,
+    0x23, 0x45, 0x67, 0xD4, 0x7D, 0xF0, 0x26, 0xC7, 0xDF, 0x02, 0x6C, 0xA7, 0xD1, 0x2F, 0x00, 0xA7,
+    0xD1, 0x1F, 0x00, 0xA7, 0xD1, 0x0F, 0x19, 0x3E, 0x60, 0xD1, 0xCF, 0x00, 0xF1, 0x76, 0xF0, 0x0F,
+    0x17, 0x5F, 0x00, 0xF1, 0x74, 0xD4, 0x3D, 0x32, 0xFF, 0xF0, 0x28, 0x1F, 0xFF, 0x00, 0xE6, 0x5E,
+    0x5A, 0xF0, 0x7E, 0x60, 0xD2, 0x2F, 0x11, 0x4E, 0x6A, 0xD5, 0x7F, 0x11, 0x5E, 0x65, 0x53, 0x22,
+    0x35, 0xD4, 0xE5, 0xAE, 0x60, 0xD2, 0xE5, 0xAD, 0x4E, 0x69, 0xDC, 0x2D, 0x4A, 0xD5, 0x99, 0x76,
+    0x9D, 0x37, 0xD4, 0x7D, 0xC0, 0xD5, 0x99, 0x77, 0x54, 0x7D, 0x35, 0xF1, 0x14, 0xF0, 0x7D, 0xCE,
+    0x60, 0xD5, 0x23, 0x5F, 0x19, 0xCE, 0x60, 0xD5, 0x23, 0x5D, 0x4A, 0xE7, 0x0D, 0xBE, 0x6A, 0xFF,
+    0xF0, 0xA0, 0x1F, 0xFD, 0x3E, 0x61, 0xEF, 0x05, 0xF0, 0x55, 0xBD, 0x1C, 0xD3, 0xBA, 0x8A, 0xBD,
+    0x2E, 0x63, 0xD3, 0x6D, 0x23, 0xDA, 0x53, 0x1E, 0x5B, 0xD2, 0xA8, 0xFF, 0xF0, 0x3C, 0x1F, 0xFD,
+    0x4E, 0x65, 0x35, 0xD2, 0x3D, 0x43, 0x35, 0x75, 0xDB, 0x3D, 0x4C, 0xF1, 0x4D, 0x37, 0xDB, 0x3F,
+    0x18, 0x2A, 0xD4, 0xAA, 0xD3, 0xA5, 0x7D, 0x28, 0xD3, 0x77, 0xD4, 0x7D, 0x37, 0x23, 0xD2, 0x5F,
+    0x14, 0x73, 0x5D, 0x33, 0xFF, 0xF0, 0xFA, 0x1F, 0xFF, 0x0F, 0xBC, 0xD2, 0xE5, 0x2D, 0x3C, 0x4D,
+    0x05, 0xDA, 0xCD, 0x27, 0xD3, 0xC9, 0xBC, 0xD0, 0xE6, 0x5D, 0x2C, 0xE5, 0x9D, 0x3C, 0xBD, 0x1E,
+    0x60, 0x24, 0xF0, 0xF2, 0xC2, 0xD3, 0xC4, 0xD8, 0x5D, 0x2E, 0x57, 0xD3, 0xC7, 0xDA, 0xE6, 0xF0,
+    0xEF, 0x0E, 0x5D, 0x3C, 0xD2, 0x4D, 0x3C, 0x2D, 0x10, 0xFF, 0xF0, 0xA0, 0x1F, 0xFD, 0x3E, 0x56,
+    0x6F, 0x04, 0x64, 0x66, 0xF0, 0x4F, 0xFF, 0x08, 0xC1, 0xFF, 0xDF, 0x03, 0x30, 0x23, 0x40, 0x2D,
+    0x24, 0xD3, 0xE5, 0xBD, 0x2E, 0x62, 0xD1, 0x0D, 0x2C, 0xDF, 0x03, 0x3C, 0xE5, 0x97, 0x69, 0xE6,
+    0x0D, 0x24, 0xD3, 0x20, 0xE5, 0x9D, 0x1E, 0x62, 0xFF, 0xF0, 0xFA, 0x1F, 0xFF, 0x0B, 0x9C, 0xF0,
+    0x64, 0xC4, 0xD2, 0x7D, 0x1C, 0xF0, 0xBD, 0x29, 0xF0, 0x6D, 0x22, 0xD3, 0x2D, 0x20, 0xFF, 0xF0,
+    0x7D, 0x1F, 0xFD, 0x5C, 0xD2, 0xE5, 0xF0, 0xC2, 0xF0, 0xC3, 0xE6, 0xF0, 0xD9, 0x3D, 0x3F, 0x0D,
+    0x03, 0xFF, 0xF0, 0x8C, 0x1F, 0xFD, 0x4E, 0x5F, 0x16, 0xD1, 0xBD, 0x4C, 0xE6, 0x0F, 0x00, 0xE5,
+    0xBF, 0x00, 0xE6, 0x0F, 0x00, 0xE5, 0xBF, 0x00, 0xE6, 0x0F, 0x00, 0xE5, 0xF1, 0x6B, 0xF0, 0x0B,
+    0xF0, 0x0B, 0xF0, 0x0B, 0xF0, 0x0B, 0xF0, 0x0B, 0xF0, 0x0B, 0xF0, 0x08, 0xF0, 0x09, 0xF0, 0x0F,
+    0x16, 0xD1, 0xBD, 0x2C, 0xD3, 0x48, 0xBD, 0x0E, 0x61, 0xD3, 0xE5, 0x69, 0xE6, 0x1D, 0x04, 0xD3,
+    0xE5, 0x9E, 0x61, 0x4D, 0x04, 0xD3, 0xE5, 0xB8, 0x9D, 0x1B, 0xFF, 0xF0, 0x50, 0x1F, 0xFD, 0x4C,
+    0xE6, 0xF0, 0x83, 0x3F, 0x08, 0x21, 0xE7, 0x1D, 0xA0, 0xD4, 0xE6, 0x86, 0xDA, 0x8F, 0xFF, 0x03,
+    0x81, 0xFF, 0xD5, 0xCE, 0xF0, 0x16, 0x8D, 0x23, 0xDF, 0x01, 0x68, 0xD2, 0xE6, 0x1D, 0x5E, 0xF0,
+    0x16, 0xDD, 0x53, 0xD2, 0x1D, 0xF0, 0x18, 0xD2, 0x3F, 0xFF, 0x0A, 0x01, 0xFF, 0xD3, 0xE5, 0x34,
+    0xD1, 0xCD, 0x36, 0x7D, 0x1C, 0xD3, 0x34, 0xF1, 0x83, 0x67, 0xF1, 0x83, 0xE6, 0x0E, 0x5B, 0xF1,
+    0x83, 0x34, 0xF1, 0x83, 0xBD, 0x1A, 0xCD, 0x49, 0x74, 0x2D, 0x14, 0xFF, 0xF0, 0x7D, 0x1F, 0xFD,
+    0x2E, 0x63, 0xD3, 0xE5, 0xAD, 0x1E, 0x63, 0xF1, 0x83, 0xE5, 0x8D, 0x2A, 0xDA, 0x3D, 0x3C, 0xD4,
+    0x7A, 0xD3, 0xE6, 0x3E, 0x5A, 0xE6, 0x5D, 0x13, 0xF1, 0x8B, 0x1D, 0x40, 0xE5, 0xAD, 0xB8, 0xD1,
+    0xAF, 0xFF, 0x07, 0xD1, 0xFF, 0xD2, 0xE6, 0xF1, 0x22, 0x05, 0x05, 0xDA, 0x9D, 0x37, 0x54, 0x21,
+    0xD2, 0xF1, 0x2A, 0x5D, 0x32, 0xD2, 0x0E, 0x5A, 0x97, 0x5C, 0xE6, 0xF1, 0x32, 0x38, 0x38, 0xDA,
+    0xE7, 0x0D, 0x3E, 0x6A, 0x87, 0x54, 0xD2, 0xF1, 0x3A, 0x8D, 0x35, 0xD2, 0x31, 0x0C, 0xE5, 0xAC,
+    0xDA, 0x8D, 0x2E, 0x63, 0x8F, 0xFF, 0x03, 0x21, 0xFF, 0xF1, 0x05, 0x35, 0x68, 0xD4, 0xAE, 0x63,
+    0xD2, 0x2F, 0x10, 0x33, 0xFF, 0xF0, 0xC8, 0x1F, 0xFD, 0x2E, 0x61, 0xF1, 0x82, 0x6F, 0x00, 0xF0,
+    0x9F, 0x00, 0xE5, 0xAD, 0x5C, 0xD3, 0x6D, 0x5C, 0xD3, 0xAD, 0x5C, 0xD2, 0x8C, 0xD5, 0x8C, 0xAC,
+    0xBC, 0xE6, 0x0C, 0xD2, 0x1F, 0x18, 0x26, 0xF0, 0x0F, 0x09, 0xF0, 0x0E, 0x5A, 0xD5, 0xCD, 0x3B,
+    0xD5, 0xCD, 0x35, 0xD5, 0xCD, 0x26, 0xFF, 0xF0, 0xA0, 0x1F, 0xFD, 0x4E, 0x49, 0x7D, 0x09, 0xD4,
+    0x75, 0x24, 0xD1, 0x1F, 0x18, 0xA2, 0xD1, 0xCD, 0x49, 0x7D, 0x09, 0xDB, 0x45, 0x1D, 0x12, 0xFF,
+    0xF0 };
+
+#endif // _PLAY_RTTTL_PACKED_MELODIES_H
@@ -0,0 +1,99 @@
+/*
+ * PlayRtttlTimerTable.h
+ *
+ * Table of Timer2 prescaler and compare values for all notes of octave 0 to 9, computed at compile time for F_CPU.
+ * Used for USE_DIRECT_TIMER2_OUTPUT, where a note is started by just writing these values to the timer registers,
+ * instead of computing them with 32 bit divisions in tone().
+ * Included by PlayRtttl.hpp if USE_DIRECT_TIMER2_OUTPUT is defined.
+ *
+ * The values are computed from the exact frequency of the note and rounded to the nearest compare value.
+ * Timer2 runs in CTC mode and toggles OC2A or OC2B at each compare match, so the output frequency is
+ * F_CPU / (2 * prescaler * (1 + compare value)).
+ *
+ *  Copyright (C) 2026  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of PlayRttl https://github.com/ArminJo/PlayRtttl.
+ *
+ *  PlayRttl is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+
+#ifndef _PLAY_RTTTL_TIMER_TABLE_H
+#define _PLAY_RTTTL_TIMER_TABLE_H
+
+#include "PlayRtttl.h"
+
+#if !defined(F_CPU)
+#error F_CPU must be defined for the Timer2 table
+#endif
+
+#define RTTTL_TIMER2_TABLE_OCTAVES      10 // Octave 0 to 9. Higher octaves use octave 9, lower notes than 30 Hz @16 MHz use the lowest possible frequency.
+#define RTTTL_TIMER2_PRESCALER_SHIFT    8  // Entry is (<CS22 to CS20 bits> << 8) | <compare value>
+#define RTTTL_TIMER2_COMPARE_MASK       0xFF
+
+/*
+ * All functions are C++11 constexpr, i.e. only one return statement, to be usable with the default Arduino compiler settings.
+ */
+// Prescaler for the CS22 to CS20 bits 1 to 7 of Timer2
+constexpr uint16_t getRtttlTimer2Prescaler(uint8_t aPrescalerBits) {
+    return aPrescalerBits == 1 ? 1 : aPrescalerBits == 2 ? 8 : aPrescalerBits == 3 ? 32 : aPrescalerBits == 4 ? 64 :
+            aPrescalerBits == 5 ? 128 : aPrescalerBits == 6 ? 256 : 1024;
+}
+
+// Exact frequency of a note, without the truncation of the integer shift in prepareNextRtttlNote()
+constexpr double getRtttlExactFrequency(int aFrequencyOfNotesOctave, uint8_t aOctave) {
+    return aOctave <= NOTES_OCTAVE ?
+            aFrequencyOfNotesOctave / (double) (1UL << (NOTES_OCTAVE - aOctave)) :
+            aFrequencyOfNotesOctave * (double) (1UL << (aOctave - NOTES_OCTAVE));
+}
+
+// Compare value rounded to nearest, may be > 255
+constexpr long getRtttlTimer2Compare(double aFrequency, uint8_t aPrescalerBits) {
+    return (long) (F_CPU / (2.0 * getRtttlTimer2Prescaler(aPrescalerBits) * aFrequency) + 0.5) - 1;
+}
+
+/*
+ * Uses the smallest prescaler where the compare value fits into 8 bit, which gives the best resolution.
+ * Frequencies below the range are clamped to prescaler 1024 and compare value 255.
+ */
+constexpr uint16_t getRtttlTimer2Entry(double aFrequency, uint8_t aPrescalerBits = 1) {
+    return getRtttlTimer2Compare(aFrequency, aPrescalerBits) <= RTTTL_TIMER2_COMPARE_MASK ?
+            (aPrescalerBits << RTTTL_TIMER2_PRESCALER_SHIFT)
+                    | (getRtttlTimer2Compare(aFrequency, aPrescalerBits) < 0 ? 0 : getRtttlTimer2Compare(aFrequency, aPrescalerBits)) :
+            (aPrescalerBits >= 7 ?
+                    (7 << RTTTL_TIMER2_PRESCALER_SHIFT) | RTTTL_TIMER2_COMPARE_MASK : getRtttlTimer2Entry(aFrequency, aPrescalerBits + 1));
+}
+
+constexpr double getRtttlTimer2Frequency(uint16_t aEntry) {
+    return F_CPU
+            / (2.0 * getRtttlTimer2Prescaler(aEntry >> RTTTL_TIMER2_PRESCALER_SHIFT)
+                    * (1 + (aEntry & RTTTL_TIMER2_COMPARE_MASK)));
+}
+
+#define RTTTL_TIMER2_ENTRY(aNote, aOctave) getRtttlTimer2Entry(getRtttlExactFrequency(aNote, aOctave))
+#define RTTTL_TIMER2_OCTAVE(aOctave) { \
+    RTTTL_TIMER2_ENTRY(NOTE_C7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_CS7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_D7, aOctave), \
+    RTTTL_TIMER2_ENTRY(NOTE_DS7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_E7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_F7, aOctave), \
+    RTTTL_TIMER2_ENTRY(NOTE_FS7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_G7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_GS7, aOctave), \
+    RTTTL_TIMER2_ENTRY(NOTE_A7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_AS7, aOctave), RTTTL_TIMER2_ENTRY(NOTE_B7, aOctave) }
+
+/*
+ * 240 bytes FLASH, indexed by [octave][index in Notes[]]
+ */
+const uint16_t RtttlTimer2Table[RTTTL_TIMER2_TABLE_OCTAVES][12] PROGMEM = { RTTTL_TIMER2_OCTAVE(0), RTTTL_TIMER2_OCTAVE(1),
+RTTTL_TIMER2_OCTAVE(2), RTTTL_TIMER2_OCTAVE(3), RTTTL_TIMER2_OCTAVE(4), RTTTL_TIMER2_OCTAVE(5), RTTTL_TIMER2_OCTAVE(6),
+RTTTL_TIMER2_OCTAVE(7), RTTTL_TIMER2_OCTAVE(8), RTTTL_TIMER2_OCTAVE(9) };
+
+#endif // _PLAY_RTTTL_TIMER_TABLE_H
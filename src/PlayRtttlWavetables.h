@@ -0,0 +1,70 @@
+/*
+ * PlayRtttlWavetables.h
+ *
+ * Wavetables, output levels and envelope for USE_WAVETABLE_OUTPUT, generated by extras/host/RtttlWavetable.
+ * A sample is RTTTL_WAVETABLE_NEGATIVE | <attenuation>, the attenuation is in steps of 6 dB / 16.
+ * The level of an attenuation is 127 * 2^(-attenuation / 16).
+ * The envelope has 5 steps attack and 48 steps decay to the sustain attenuation 16, one step is about 1 ms.
+ */
+
+#ifndef _PLAY_RTTTL_WAVETABLES_H
+#define _PLAY_RTTTL_WAVETABLES_H
+
+#include "PlayRtttl.h"
+
+#define RTTTL_WAVETABLE_SIZE_SHIFT      6
+#define RTTTL_WAVETABLE_NEGATIVE        0x80
+#define RTTTL_WAVETABLE_ATTENUATION_MASK 0x7F
+#define RTTTL_WAVETABLE_SILENT          128 // Attenuation of silence, also the number of levels
+#define RTTTL_WAVETABLE_ATTACK_LENGTH   5 // The last step of the attack has attenuation 0
+#define RTTTL_WAVETABLE_ENVELOPE_LENGTH 53
+
+static const uint8_t RtttlWavetables[RTTTL_NUMBER_OF_WAVEFORMS][1 << RTTTL_WAVETABLE_SIZE_SHIFT] PROGMEM = {
+    // sine
+    {
+        0x46, 0x2C, 0x21, 0x19, 0x14, 0x0F, 0x0C, 0x09, 0x07, 0x05, 0x04, 0x02, 0x01, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x01, 0x01, 0x02, 0x04, 0x05, 0x07, 0x09, 0x0C, 0x0F, 0x14, 0x19, 0x21, 0x2C, 0x46,
+        0xC6, 0xAC, 0xA1, 0x99, 0x94, 0x8F, 0x8C, 0x89, 0x87, 0x85, 0x84, 0x82, 0x81, 0x81, 0x80, 0x80,
+        0x80, 0x80, 0x81, 0x81, 0x82, 0x84, 0x85, 0x87, 0x89, 0x8C, 0x8F, 0x94, 0x99, 0xA1, 0xAC, 0xC6 },
+    // triangle
+    {
+        0x50, 0x37, 0x2B, 0x23, 0x1D, 0x19, 0x15, 0x11, 0x0F, 0x0C, 0x0A, 0x08, 0x06, 0x04, 0x02, 0x01,
+        0x01, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0F, 0x11, 0x15, 0x19, 0x1D, 0x23, 0x2B, 0x37, 0x50,
+        0xD0, 0xB7, 0xAB, 0xA3, 0x9D, 0x99, 0x95, 0x91, 0x8F, 0x8C, 0x8A, 0x88, 0x86, 0x84, 0x82, 0x81,
+        0x81, 0x82, 0x84, 0x86, 0x88, 0x8A, 0x8C, 0x8F, 0x91, 0x95, 0x99, 0x9D, 0xA3, 0xAB, 0xB7, 0xD0 },
+    // pulse50
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    // pulse25
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+        0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+        0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99 },
+    // pulse12
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD,
+        0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD,
+        0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD,
+        0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD, 0xAD } };
+
+static const uint8_t RtttlWavetableLevels[RTTTL_WAVETABLE_SILENT] PROGMEM = {
+    0x7F, 0x7A, 0x74, 0x70, 0x6B, 0x66, 0x62, 0x5E, 0x5A, 0x56, 0x52, 0x4F, 0x4C, 0x48, 0x45, 0x42,
+    0x40, 0x3D, 0x3A, 0x38, 0x35, 0x33, 0x31, 0x2F, 0x2D, 0x2B, 0x29, 0x27, 0x26, 0x24, 0x23, 0x21,
+    0x20, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x18, 0x17, 0x16, 0x15, 0x15, 0x14, 0x13, 0x12, 0x11, 0x11,
+    0x10, 0x0F, 0x0F, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x09, 0x08,
+    0x08, 0x08, 0x07, 0x07, 0x07, 0x06, 0x06, 0x06, 0x06, 0x05, 0x05, 0x05, 0x05, 0x05, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 };
+
+static const uint8_t RtttlWavetableEnvelope[RTTTL_WAVETABLE_ENVELOPE_LENGTH] PROGMEM = {
+    0x25, 0x15, 0x0C, 0x05, 0x00, 0x00, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x03, 0x03, 0x03, 0x04,
+    0x04, 0x04, 0x05, 0x05, 0x05, 0x06, 0x06, 0x06, 0x07, 0x07, 0x07, 0x08, 0x08, 0x08, 0x09, 0x09,
+    0x09, 0x0A, 0x0A, 0x0A, 0x0B, 0x0B, 0x0B, 0x0C, 0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0E, 0x0E, 0x0E,
+    0x0F, 0x0F, 0x0F, 0x10, 0x10 };
+
+#endif // _PLAY_RTTTL_WAVETABLES_H